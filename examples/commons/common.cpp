@@ -1,5 +1,6 @@
 #include "common.hpp"
 
+#include <glpp/extensions.hpp>
 #include <glpp/gl.h>
 
 #include <iostream>
@@ -45,6 +46,7 @@ GLFWwindow* SetupGL(const char* title) {
     glfwTerminate();
     exit(EXIT_FAILURE);
   }
+  glpp::LoadExtensions(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
 
   glfwSwapInterval(1);
   return window;
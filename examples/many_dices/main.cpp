@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <array>
 #include <common.hpp>
 #include <glm/glm.hpp>
@@ -76,8 +77,7 @@ int main() {
   for (auto& r : rotations) {
     r = sphericalRand(1.0f);
   }
-  Buffer transform_buffer;
-  transform_buffer.CreateStorage(transforms, GL_DYNAMIC_STORAGE_BIT);
+  StreamingBuffer transform_stream(transforms.size() * sizeof(mat4));
 
   Buffer vbo;
   vbo.CreateStorage(vertices);
@@ -87,7 +87,7 @@ int main() {
 
   VertexArray vao;
   vao.BindElementBuffer(ebo);
-  vao.BindVertexBuffer(0, transform_buffer, sizeof(mat4));
+  vao.BindVertexBuffer(0, transform_stream.GetBuffer(), sizeof(mat4));
   vao.BindingDivisor(0, 1);
   vao.EnableAttrib(0, 1, 2, 3);
   vao.AttribBinding(0, 0, 1, 2, 3);
@@ -109,6 +109,7 @@ int main() {
   }
   texture.BindUnit(0);
   program.Uniform("faces", 0);
+  auto view_persp = program.GetUniform<mat4>("viewPersp");
 
   program.Use();
   vao.Bind();
@@ -121,15 +122,19 @@ int main() {
 
     const auto ratio = (float)width / height;
     const auto p = perspective(pi<float>() / 3, ratio, .01f, 100.f);
-    program.Uniform("viewPersp", p);
+    view_persp.Set(p);
 
     for (int i = 0; i < grid * grid; ++i) {
       transforms[i] = rotate(transforms[i], 0.02f, rotations[i]);
     }
-    transform_buffer.SetSubData(transforms);
+    const auto region = transform_stream.Acquire();
+    copy(transforms.begin(), transforms.end(), static_cast<mat4*>(region.data));
+    vao.BindVertexBuffer(0, transform_stream.GetBuffer(), sizeof(mat4),
+                         region.offset);
 
     glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr,
                             grid * grid);
+    transform_stream.Release();
 
     glfwSwapBuffers(window);
     glfwPollEvents();
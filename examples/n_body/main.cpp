@@ -1,5 +1,6 @@
 #include <array>
 #include <common.hpp>
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/random.hpp>
@@ -14,9 +15,14 @@ using namespace std;
 
 namespace {
 struct Particle {
-  vec3 position;
-  vec3 velocity;
-  vec3 acceleration;
+  vec4 position;
+  vec4 velocity;
+  vec4 acceleration;
+};
+
+struct Frame {
+  mat4 view;
+  mat4 persp;
 };
 
 string computer_shader_source = R"(
@@ -24,9 +30,9 @@ string computer_shader_source = R"(
 layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
 
 struct Particle {
-  float px, py, pz;
-  float vx, vy, vz;
-  float ax, ay, az;
+  vec4 position;
+  vec4 velocity;
+  vec4 acceleration;
 };
 
 layout(std430, binding = 0) buffer input_particles {
@@ -41,29 +47,23 @@ uniform float dt;
 
 void main() {
   const uint id = gl_WorkGroupID.x;
-  const vec3 p = vec3(inputs[id].px, inputs[id].py, inputs[id].pz);
-  const vec3 v = vec3(inputs[id].vx, inputs[id].vy, inputs[id].vz);
-  const vec3 a = vec3(inputs[id].ax, inputs[id].ay, inputs[id].az);
+  const vec3 p = inputs[id].position.xyz;
+  const vec3 v = inputs[id].velocity.xyz;
+  const vec3 a = inputs[id].acceleration.xyz;
 
   vec3 a_o = vec3(0);
-  for (uint i = 0; i < inputs.length(); ++i) {
+  for (uint i = 0; i < PARTICLE_COUNT; ++i) {
     if (i == id) continue;
-    const vec3 d = vec3(inputs[i].px, inputs[i].py, inputs[i].pz)-p;
+    const vec3 d = inputs[i].position.xyz-p;
     a_o += 1/dot(d, d)*normalize(d);
   }
 
   const vec3 v_o = v+(a+a_o)/2*dt;
   const vec3 p_o = p+(v+v_o)/2*dt;
 
-  outputs[id].px = p_o.x;
-  outputs[id].py = p_o.y;
-  outputs[id].pz = p_o.z;
-  outputs[id].vx = v_o.x;
-  outputs[id].vy = v_o.y;
-  outputs[id].vz = v_o.z;
-  outputs[id].ax = a_o.x;
-  outputs[id].ay = a_o.y;
-  outputs[id].az = a_o.z;
+  outputs[id].position = vec4(p_o, 1);
+  outputs[id].velocity = vec4(v_o, 0);
+  outputs[id].acceleration = vec4(a_o, 0);
 }
 )";
 
@@ -74,8 +74,10 @@ layout(location = 0) in vec3 pos;
 layout(location = 1) in vec3 vel;
 layout(location = 2) in vec3 acc;
 
-uniform mat4 view;
-uniform mat4 persp;
+layout(std140) uniform Frame {
+  mat4 view;
+  mat4 persp;
+};
 
 const float zFar = 1000;
 const float accMax = 1;
@@ -153,36 +155,47 @@ vector<Particle> InitParticles() {
     const auto r =
         frame * vec3{circularRand(R * pow(linearRand(0.f, 1.f), 1 / 3.f)),
                      gaussRand(0.f, 1.f)};
-    particles[i - 1] = Particle{r, cross(w, r), {0, 0, 0}};
-    particles[i] = Particle{-r, cross(w, -r), {0, 0, 0}};
+    particles[i - 1] = Particle{vec4{r, 1}, vec4{cross(w, r), 0}, vec4{0}};
+    particles[i] = Particle{vec4{-r, 1}, vec4{cross(w, -r), 0}, vec4{0}};
   }
   return particles;
 }
 }  // namespace
 
+GLPP_LAYOUT(Std430, Particle, position, velocity, acceleration);
+GLPP_LAYOUT(Std140, Frame, view, persp);
+
 int main() {
   const auto window = SetupGL("N-body Simulation");
 
+  auto particles = InitParticles();
+
   Program program{VertexShader{vertex_shader_source},
-                  FragmentShader{fragment_shader_source}},
-      compute_program{ComputeShader{computer_shader_source}};
+                  FragmentShader{fragment_shader_source}};
+  ShaderVariants variants;
+  auto &compute_program = variants.GetProgram(
+      {{ShaderStage::COMPUTE_SHADER, computer_shader_source}},
+      {{"PARTICLE_COUNT", to_string(particles.size()) + "u"}});
 
-  auto particles = InitParticles();
+  UniformBlock<Frame> frame{0};
+  frame.Attach(program, "Frame");
 
-  Buffer buffer[2];
+  TypedBuffer<Particle> buffer[2];
   buffer[0].CreateStorage(particles);
-  buffer[1].CreateStorage(particles.size() * sizeof(Particle), nullptr);
+  buffer[1].CreateStorage(particles.size());
 
-  buffer[0].BindBase(BufferTarget::SHADER_STORAGE_BUFFER, 0);
-  buffer[1].BindBase(BufferTarget::SHADER_STORAGE_BUFFER, 1);
+  const auto &input = compute_program.GetStorageBlock("input_particles");
+  const auto &output = compute_program.GetStorageBlock("output_particles");
+  buffer[0].BindBase(BufferTarget::SHADER_STORAGE_BUFFER, input.binding);
+  buffer[1].BindBase(BufferTarget::SHADER_STORAGE_BUFFER, output.binding);
 
   VertexArray vao;
   vao.BindVertexBuffer(0, buffer[0], sizeof(Particle));
   vao.EnableAttrib(0, 1, 2);
   vao.AttribBinding(0, 0, 1, 2);
-  vao.AttribFormat<vec3>(0, 0);
-  vao.AttribFormat<vec3>(1, sizeof(vec3));
-  vao.AttribFormat<vec3>(2, 2 * sizeof(vec3));
+  vao.AttribFormat<vec3>(0, offsetof(Particle, position));
+  vao.AttribFormat<vec3>(1, offsetof(Particle, velocity));
+  vao.AttribFormat<vec3>(2, offsetof(Particle, acceleration));
 
   vao.Bind();
 
@@ -208,8 +221,7 @@ int main() {
     const auto ratio = (float)width / height;
     const auto p = perspective(pi<float>() / 3, ratio, .01f, 1000.f);
     const auto v = lookAt(vec3{0, 0, 500}, vec3{0, 0, 0}, vec3{0, 1, 0});
-    program.Uniform("view", v);
-    program.Uniform("persp", p);
+    frame.Update({v, p});
     glDrawArrays(GL_POINTS, 0, particles.size());
 
     glfwSwapBuffers(window);
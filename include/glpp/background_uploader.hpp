@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "gl.h"
+#include "name_pool.hpp"
+#include "sync.hpp"
+
+namespace glpp {
+/**
+ * Result of a background upload, handed to the render thread
+ */
+template <typename T>
+class Upload {
+  static_assert(!std::is_void_v<T>, "Upload task must return its objects");
+
+ public:
+  struct Result {
+    T value;
+    Fence fence;
+  };
+
+  explicit Upload(std::future<Result> future) : future_{std::move(future)} {}
+
+  [[nodiscard]] bool IsReady() const {
+    return future_.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  }
+
+  /**
+   * Wait for the task and make the calling context wait on its commands.
+   * Objects modified by the task must be bound again to see the changes.
+   */
+  T Get() {
+    auto result = future_.get();
+    result.fence.ServerWait();
+    return std::move(result.value);
+  }
+
+ private:
+  std::future<Result> future_;
+};
+
+/**
+ * Runs creation and upload tasks on a worker thread with its own context,
+ * which must share objects with the render context. Container objects such
+ * as vertex arrays are not shared and must be created on the render thread.
+ */
+class BackgroundUploader {
+ public:
+  /**
+   * make_current makes the shared context current on the worker thread, e.g.
+   * glfwMakeContextCurrent on a hidden window; release runs before it exits.
+   */
+  explicit BackgroundUploader(std::function<void()> make_current,
+                              std::function<void()> release = {})
+      : make_current_{std::move(make_current)},
+        release_{std::move(release)},
+        worker_{&BackgroundUploader::Run, this} {}
+
+  BackgroundUploader(const BackgroundUploader &) = delete;
+
+  BackgroundUploader &operator=(const BackgroundUploader &) = delete;
+
+  ~BackgroundUploader() {
+    {
+      std::lock_guard lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    worker_.join();
+  }
+
+  /**
+   * Run task() on the worker; its result is fenced and flushed
+   */
+  template <typename F>
+  auto Submit(F &&task) {
+    using T = std::invoke_result_t<F>;
+    using Result = typename Upload<T>::Result;
+    auto promise = std::make_shared<std::promise<Result>>();
+    Upload<T> upload{promise->get_future()};
+
+    std::packaged_task<void()> job(
+        [promise, task = std::forward<F>(task)]() mutable {
+          try {
+            auto value = task();
+            auto fence = Fence::Insert();
+            glFlush();
+            promise->set_value({std::move(value), std::move(fence)});
+          } catch (...) {
+            promise->set_exception(std::current_exception());
+          }
+        });
+    {
+      std::lock_guard lock(mutex_);
+      tasks_.push_back(std::move(job));
+    }
+    cv_.notify_one();
+    return upload;
+  }
+
+ private:
+  void Run() {
+    make_current_();
+    while (true) {
+      std::unique_lock lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) break;
+      auto task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      task();
+    }
+    FlushNames();
+    if (release_) release_();
+  }
+
+  std::function<void()> make_current_, release_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::packaged_task<void()>> tasks_;
+  bool stop_{false};
+  std::thread worker_;
+};
+}  // namespace glpp
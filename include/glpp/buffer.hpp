@@ -1,25 +1,54 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
 #include "details/object.hpp"
+#include "extensions.hpp"
 #include "gl.h"
+#include "name_pool.hpp"
 
 namespace glpp {
 enum class BufferTarget : GLenum {
   ARRAY_BUFFER = GL_ARRAY_BUFFER,
   ELEMENT_ARRAY_BUFFER = GL_ELEMENT_ARRAY_BUFFER,
   DRAW_INDIRECT_BUFFER = GL_DRAW_INDIRECT_BUFFER,
-  SHADER_STORAGE_BUFFER = GL_SHADER_STORAGE_BUFFER
+  SHADER_STORAGE_BUFFER = GL_SHADER_STORAGE_BUFFER,
+  UNIFORM_BUFFER = GL_UNIFORM_BUFFER
+};
+
+/**
+ * Source bytes to be written at offset
+ */
+struct BufferWrite {
+  const void *data;
+  GLintptr offset;
+  GLsizeiptr size;
+};
+
+/**
+ * count elements of element_size bytes, stride bytes apart
+ */
+struct StridedView {
+  const void *data;
+  GLsizeiptr element_size;
+  GLsizeiptr stride;
+  std::size_t count;
 };
 
 namespace details {
 struct BufferTrait {
-  static GLuint Create() {
-    GLuint id;
-    glCreateBuffers(1, &id);
-    return id;
-  }
+  static GLuint Create() { return NamePool<BufferTrait>::Get().Acquire(); }
+
+  static void Create(GLsizei n, GLuint *ids) { glCreateBuffers(n, ids); }
 
-  static void Delete(GLuint id) { glDeleteBuffers(1, &id); }
+  static void Delete(GLuint id) { NamePool<BufferTrait>::Get().Release(id); }
+
+  static void Delete(GLsizei n, const GLuint *ids) { glDeleteBuffers(n, ids); }
 
   using Target = BufferTarget;
 
@@ -31,10 +60,17 @@ struct BufferTrait {
 
 class Buffer : public details::Object<details::BufferTrait> {
  public:
+  using details::Object<details::BufferTrait>::Object;
+
   void BindBase(BufferTarget target, GLuint index) {
     glBindBufferBase(static_cast<GLenum>(target), index, Id());
   }
 
+  void BindRange(BufferTarget target, GLuint index, GLintptr offset,
+                 GLsizeiptr size) {
+    glBindBufferRange(static_cast<GLenum>(target), index, Id(), offset, size);
+  }
+
   void CreateStorage(GLsizeiptr size, const void *data = nullptr,
                      GLbitfield flags = 0) {
     glNamedBufferStorage(Id(), size, data, flags);
@@ -59,6 +95,69 @@ class Buffer : public details::Object<details::BufferTrait> {
                offset);
   }
 
+  /**
+   * Write every source through a single mapping of the range they span.
+   * Needs GL_MAP_WRITE_BIT storage. The range is invalidated when the writes
+   * cover it entirely; if they leave gaps, the map waits for the GPU to be
+   * done with the buffer.
+   */
+  void Gather(const BufferWrite *writes, std::size_t count) {
+    if (count == 0) return;
+    std::vector<std::pair<GLintptr, GLintptr>> ranges(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      ranges[i] = {writes[i].offset, writes[i].offset + writes[i].size};
+    }
+    std::sort(ranges.begin(), ranges.end());
+    const auto first = ranges.front().first;
+    auto last = ranges.front().second;
+    bool covered = true;
+    for (const auto &[begin, end] : ranges) {
+      covered = covered && begin <= last;
+      last = std::max(last, end);
+    }
+    auto access = GLbitfield(GL_MAP_WRITE_BIT);
+    if (covered) access |= GL_MAP_INVALIDATE_RANGE_BIT;
+    const auto dst =
+        static_cast<unsigned char *>(MapRange(first, last - first, access));
+    for (std::size_t i = 0; i < count; ++i) {
+      std::memcpy(dst + (writes[i].offset - first), writes[i].data,
+                  writes[i].size);
+    }
+    Unmap();
+  }
+
+  void Gather(std::initializer_list<BufferWrite> writes) {
+    Gather(writes.begin(), writes.size());
+  }
+
+  // For STL containers
+  template <typename Container>
+  void Gather(const Container &writes) {
+    Gather(writes.data(), writes.size());
+  }
+
+  /**
+   * Write strided elements starting at offset, dst_stride bytes apart or
+   * tightly packed if 0. Needs GL_MAP_WRITE_BIT storage.
+   */
+  void Gather(const StridedView &src, GLintptr offset,
+              GLsizeiptr dst_stride = 0) {
+    if (src.count == 0) return;
+    if (dst_stride == 0) dst_stride = src.element_size;
+    const auto length =
+        GLsizeiptr(src.count - 1) * dst_stride + src.element_size;
+    auto access = GLbitfield(GL_MAP_WRITE_BIT);
+    if (dst_stride == src.element_size) access |= GL_MAP_INVALIDATE_RANGE_BIT;
+    auto dst = static_cast<unsigned char *>(MapRange(offset, length, access));
+    auto data = static_cast<const unsigned char *>(src.data);
+    for (std::size_t i = 0; i < src.count; ++i) {
+      std::memcpy(dst, data, src.element_size);
+      dst += dst_stride;
+      data += src.stride;
+    }
+    Unmap();
+  }
+
   void *MapRange(GLintptr offset, GLsizeiptr length, GLbitfield access) {
     return glMapNamedBufferRange(Id(), offset, length, access);
   }
@@ -67,11 +166,52 @@ class Buffer : public details::Object<details::BufferTrait> {
 
   void InvalidateData() { glInvalidateBufferData(Id()); }
 
+  void ClearData(GLenum internalformat, GLenum format, GLenum type,
+                 const void *data = nullptr) {
+    glClearNamedBufferData(Id(), internalformat, format, type, data);
+  }
+
+  void ClearSubData(GLenum internalformat, GLintptr offset, GLsizeiptr size,
+                    GLenum format, GLenum type, const void *data = nullptr) {
+    glClearNamedBufferSubData(Id(), internalformat, offset, size, format, type,
+                              data);
+  }
+
+  /**
+   * Fill a range with a repeated 32-bit pattern on the GPU, offset and size
+   * must be multiples of 4
+   */
+  void Fill(GLintptr offset, GLsizeiptr size, GLuint pattern = 0) {
+    ClearSubData(GL_R32UI, offset, size, GL_RED_INTEGER, GL_UNSIGNED_INT,
+                 &pattern);
+  }
+
+  /**
+   * Commit or decommit pages of a GL_SPARSE_STORAGE_BIT_ARB buffer
+   */
+  void PageCommitment(GLintptr offset, GLsizeiptr size, bool commit) {
+    const auto f = details::extensions.named_buffer_page_commitment;
+    if (!f) throw std::runtime_error("GL_ARB_sparse_buffer not loaded");
+    f(Id(), offset, size, commit ? GL_TRUE : GL_FALSE);
+  }
+
+  static GLsizeiptr SparsePageSize() {
+    GLint size;
+    glGetIntegerv(GL_SPARSE_BUFFER_PAGE_SIZE_ARB, &size);
+    return size;
+  }
+
   static void CopySubData(const Buffer &read_buffer, Buffer &write_buffer,
                           GLintptr readOffset, GLintptr writeOffset,
-                          GLsizei size) {
+                          GLsizeiptr size) {
     glCopyNamedBufferSubData(read_buffer.Id(), write_buffer.Id(), readOffset,
                              writeOffset, size);
   }
 };
+
+struct BufferRange {
+  Buffer *buffer;
+  GLintptr offset;
+  GLsizeiptr size;
+};
 }  // namespace glpp
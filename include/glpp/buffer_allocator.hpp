@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "buffer.hpp"
+#include "gl.h"
+
+namespace glpp {
+/**
+ * Best-fit sub-allocator carving ranges out of a few large immutable buffers.
+ * Ranges are referred to by handles since Defragment() may move them.
+ */
+class BufferAllocator {
+ public:
+  using Handle = std::uint32_t;
+
+  explicit BufferAllocator(GLsizeiptr page_size = GLsizeiptr(64) << 20,
+                           GLbitfield flags = GL_DYNAMIC_STORAGE_BIT,
+                           GLsizeiptr alignment = 16)
+      : page_size_{AlignUp(page_size, alignment)},
+        flags_{flags},
+        alignment_{alignment} {}
+
+  Handle Allocate(GLsizeiptr size) {
+    size = AlignUp(std::max<GLsizeiptr>(size, 1), alignment_);
+    auto [page, offset] = AllocateBlock(size, kNoPage);
+    if (page == kNoPage) {
+      page = AddPage(std::max(size, page_size_));
+      offset = TakeBlock(*pages_[page], size);
+    }
+
+    Handle handle;
+    if (free_handles_.empty()) {
+      handle = Handle(allocations_.size());
+      allocations_.emplace_back();
+    } else {
+      handle = free_handles_.back();
+      free_handles_.pop_back();
+    }
+    allocations_[handle] = {page, offset, size, true};
+    return handle;
+  }
+
+  template <typename T>
+  Handle Allocate(GLsizeiptr count) {
+    return Allocate(count * GLsizeiptr(sizeof(T)));
+  }
+
+  void Free(Handle handle) {
+    auto &alloc = At(handle);
+    ReleaseBlock(*pages_[alloc.page], alloc.offset, alloc.size);
+    alloc.live = false;
+    free_handles_.push_back(handle);
+  }
+
+  /**
+   * Resize a range in place if possible, otherwise move it with a GPU copy
+   */
+  void Reallocate(Handle handle, GLsizeiptr size) {
+    size = AlignUp(std::max<GLsizeiptr>(size, 1), alignment_);
+    auto &alloc = At(handle);
+    auto &page = *pages_[alloc.page];
+    if (size <= alloc.size) {
+      if (size < alloc.size) {
+        ReleaseBlock(page, alloc.offset + size, alloc.size - size);
+      }
+      alloc.size = size;
+      return;
+    }
+
+    const auto next = page.free_blocks.find(alloc.offset + alloc.size);
+    if (next != page.free_blocks.end() &&
+        alloc.size + next->second >= size) {
+      const auto block_offset = next->first, block_size = next->second;
+      EraseFree(page, next);
+      page.used += block_size;
+      const auto grown = size - alloc.size;
+      if (block_size > grown) {
+        ReleaseBlock(page, block_offset + grown, block_size - grown);
+      }
+      alloc.size = size;
+      return;
+    }
+
+    auto [new_page, new_offset] = AllocateBlock(size, kNoPage);
+    if (new_page == kNoPage) {
+      new_page = AddPage(std::max(size, page_size_));
+      new_offset = TakeBlock(*pages_[new_page], size);
+    }
+    Buffer::CopySubData(page.buffer, pages_[new_page]->buffer, alloc.offset,
+                        new_offset, alloc.size);
+    ReleaseBlock(page, alloc.offset, alloc.size);
+    alloc.page = new_page;
+    alloc.offset = new_offset;
+    alloc.size = size;
+  }
+
+  [[nodiscard]] BufferRange Get(Handle handle) const {
+    const auto &alloc = At(handle);
+    return {&pages_[alloc.page]->buffer, alloc.offset, alloc.size};
+  }
+
+  /**
+   * Incrementally empty the least used page into the others, moving at most
+   * max_bytes, and release pages left empty. Returns the number of bytes
+   * moved; ranges obtained with Get() before are stale if it is nonzero.
+   */
+  GLsizeiptr Defragment(GLsizeiptr max_bytes) {
+    ReleaseEmptyPages();
+
+    std::size_t source = kNoPage;
+    std::size_t live_pages = 0;
+    for (std::size_t i = 0; i < pages_.size(); ++i) {
+      if (!pages_[i]) continue;
+      ++live_pages;
+      if (source == kNoPage || pages_[i]->used < pages_[source]->used) {
+        source = i;
+      }
+    }
+    if (live_pages < 2) return 0;
+
+    GLsizeiptr moved = 0;
+    for (auto &alloc : allocations_) {
+      if (!alloc.live || alloc.page != source) continue;
+      if (moved + alloc.size > max_bytes) break;
+      const auto [page, offset] = AllocateBlock(alloc.size, source);
+      if (page == kNoPage) break;
+      Buffer::CopySubData(pages_[source]->buffer, pages_[page]->buffer,
+                          alloc.offset, offset, alloc.size);
+      ReleaseBlock(*pages_[source], alloc.offset, alloc.size);
+      alloc.page = page;
+      alloc.offset = offset;
+      moved += alloc.size;
+    }
+
+    ReleaseEmptyPages();
+    return moved;
+  }
+
+  [[nodiscard]] std::size_t PageCount() const {
+    return std::count_if(pages_.begin(), pages_.end(),
+                         [](const auto &page) { return bool(page); });
+  }
+
+ private:
+  static constexpr std::size_t kNoPage = ~std::size_t{0};
+
+  struct Page {
+    Buffer buffer;
+    GLsizeiptr size;
+    GLsizeiptr used{0};
+    std::map<GLintptr, GLsizeiptr> free_blocks;
+    std::multimap<GLsizeiptr, GLintptr> free_sizes;
+  };
+
+  struct Allocation {
+    std::size_t page;
+    GLintptr offset;
+    GLsizeiptr size;
+    bool live;
+  };
+
+  static GLsizeiptr AlignUp(GLsizeiptr size, GLsizeiptr alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  Allocation &At(Handle handle) {
+    if (handle >= allocations_.size() || !allocations_[handle].live) {
+      throw std::out_of_range("Invalid buffer allocation handle");
+    }
+    return allocations_[handle];
+  }
+
+  [[nodiscard]] const Allocation &At(Handle handle) const {
+    return const_cast<BufferAllocator &>(*this).At(handle);
+  }
+
+  std::size_t AddPage(GLsizeiptr size) {
+    auto page = std::make_unique<Page>();
+    page->size = size;
+    page->buffer.CreateStorage(size, nullptr, flags_);
+    InsertFree(*page, 0, size);
+
+    const auto empty = std::find(pages_.begin(), pages_.end(), nullptr);
+    if (empty != pages_.end()) {
+      *empty = std::move(page);
+      return std::distance(pages_.begin(), empty);
+    }
+    pages_.push_back(std::move(page));
+    return pages_.size() - 1;
+  }
+
+  void ReleaseEmptyPages() {
+    for (auto &page : pages_) {
+      if (page && page->used == 0) page.reset();
+    }
+  }
+
+  /**
+   * Best fit over all pages except the excluded one
+   */
+  std::pair<std::size_t, GLintptr> AllocateBlock(GLsizeiptr size,
+                                                 std::size_t excluded) {
+    std::size_t best = kNoPage;
+    GLsizeiptr best_size = 0;
+    for (std::size_t i = 0; i < pages_.size(); ++i) {
+      if (!pages_[i] || i == excluded) continue;
+      const auto it = pages_[i]->free_sizes.lower_bound(size);
+      if (it == pages_[i]->free_sizes.end()) continue;
+      if (best == kNoPage || it->first < best_size) {
+        best = i;
+        best_size = it->first;
+      }
+    }
+    if (best == kNoPage) return {kNoPage, 0};
+    return {best, TakeBlock(*pages_[best], size)};
+  }
+
+  static GLintptr TakeBlock(Page &page, GLsizeiptr size) {
+    const auto it = page.free_sizes.lower_bound(size);
+    const auto block_size = it->first, offset = it->second;
+    EraseFree(page, page.free_blocks.find(offset));
+    if (block_size > size) InsertFree(page, offset + size, block_size - size);
+    page.used += size;
+    return offset;
+  }
+
+  static void ReleaseBlock(Page &page, GLintptr offset, GLsizeiptr size) {
+    page.used -= size;
+
+    // Coalesce with the neighbouring free blocks
+    auto next = page.free_blocks.lower_bound(offset);
+    if (next != page.free_blocks.end() && next->first == offset + size) {
+      size += next->second;
+      next = EraseFree(page, next);
+    }
+    if (next != page.free_blocks.begin()) {
+      const auto prev = std::prev(next);
+      if (prev->first + prev->second == offset) {
+        offset = prev->first;
+        size += prev->second;
+        EraseFree(page, prev);
+      }
+    }
+    InsertFree(page, offset, size);
+  }
+
+  static void InsertFree(Page &page, GLintptr offset, GLsizeiptr size) {
+    page.free_blocks.emplace(offset, size);
+    page.free_sizes.emplace(size, offset);
+  }
+
+  static std::map<GLintptr, GLsizeiptr>::iterator EraseFree(
+      Page &page, std::map<GLintptr, GLsizeiptr>::iterator block) {
+    auto [first, last] = page.free_sizes.equal_range(block->second);
+    for (; first != last; ++first) {
+      if (first->second == block->first) {
+        page.free_sizes.erase(first);
+        break;
+      }
+    }
+    return page.free_blocks.erase(block);
+  }
+
+  GLsizeiptr page_size_;
+  GLbitfield flags_;
+  GLsizeiptr alignment_;
+  std::vector<std::unique_ptr<Page>> pages_;
+  std::vector<Allocation> allocations_;
+  std::vector<Handle> free_handles_;
+};
+}  // namespace glpp
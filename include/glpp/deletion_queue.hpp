@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "gl.h"
+
+namespace glpp {
+/**
+ * When deferred, objects destroyed on any thread push their names into a
+ * lock-free queue instead of deleting them; the context thread deletes them
+ * with Drain() or Collect().
+ */
+class DeletionQueue {
+ public:
+  using Deleter = void (*)(GLuint);
+  using BatchDeleter = void (*)(GLsizei, const GLuint *);
+  using SyncDeleter = void (*)(GLsync);
+
+  static DeletionQueue &Get() {
+    static DeletionQueue queue;
+    return queue;
+  }
+
+  DeletionQueue(const DeletionQueue &) = delete;
+
+  DeletionQueue &operator=(const DeletionQueue &) = delete;
+
+  ~DeletionQueue() {
+    // The context is likely gone, only free the memory
+    DeleteNodes(head_.exchange(nullptr), false);
+    for (auto &batch : retired_) DeleteNodes(batch.nodes, false);
+  }
+
+  void SetDeferred(bool deferred) {
+    deferred_.store(deferred, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] bool IsDeferred() const {
+    return deferred_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Queue a name, a batch of names or a sync object. Thread-safe and
+   * lock-free.
+   */
+  void Push(Deleter deleter, GLuint id) {
+    PushNode([deleter, id] { deleter(id); });
+  }
+
+  void Push(BatchDeleter deleter, std::vector<GLuint> ids) {
+    PushNode([deleter, ids = std::move(ids)] {
+      deleter(GLsizei(ids.size()), ids.data());
+    });
+  }
+
+  void Push(SyncDeleter deleter, GLsync sync) {
+    PushNode([deleter, sync] { deleter(sync); });
+  }
+
+  /**
+   * Delete everything queued, on the context thread
+   */
+  void Drain() {
+    for (auto &batch : retired_) {
+      glDeleteSync(batch.fence);
+      DeleteNodes(batch.nodes, true);
+    }
+    retired_.clear();
+    DeleteNodes(Take(), true);
+  }
+
+  /**
+   * Fence the names queued so far and delete those whose fence signaled,
+   * keeping objects alive until prior commands completed. Call on the
+   * context thread at frame boundaries.
+   */
+  void Collect() {
+    if (const auto nodes = Take()) {
+      retired_.push_back(
+          {nodes, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+    }
+    while (!retired_.empty() && IsSignaled(retired_.front().fence)) {
+      glDeleteSync(retired_.front().fence);
+      DeleteNodes(retired_.front().nodes, true);
+      retired_.pop_front();
+    }
+  }
+
+ private:
+  struct Node {
+    std::function<void()> deleter;
+    Node *next;
+  };
+
+  // A raw sync object, as Fence itself is deleted through the queue
+  struct Batch {
+    Node *nodes;
+    GLsync fence;
+  };
+
+  DeletionQueue() = default;
+
+  void PushNode(std::function<void()> deleter) {
+    const auto node =
+        new Node{std::move(deleter), head_.load(std::memory_order_relaxed)};
+    while (!head_.compare_exchange_weak(node->next, node,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+    }
+  }
+
+  static bool IsSignaled(GLsync sync) {
+    GLint status;
+    glGetSynciv(sync, GL_SYNC_STATUS, 1, nullptr, &status);
+    return status == GL_SIGNALED;
+  }
+
+  Node *Take() { return head_.exchange(nullptr, std::memory_order_acquire); }
+
+  static void DeleteNodes(Node *node, bool delete_names) {
+    while (node) {
+      if (delete_names) node->deleter();
+      const auto next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  std::atomic<Node *> head_{nullptr};
+  std::atomic<bool> deferred_{false};
+  std::deque<Batch> retired_;
+};
+}  // namespace glpp
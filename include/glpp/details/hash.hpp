@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace glpp::details {
+constexpr std::uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ULL;
+
+/**
+ * 64-bit FNV-1a, chained by passing the previous hash
+ */
+constexpr std::uint64_t Fnv1a(std::string_view data,
+                              std::uint64_t hash = kFnvOffsetBasis) {
+  for (const auto c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+template <typename T,
+          typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+std::uint64_t Fnv1a(const T &val, std::uint64_t hash = kFnvOffsetBasis) {
+  return Fnv1a({reinterpret_cast<const char *>(&val), sizeof(T)}, hash);
+}
+}  // namespace glpp::details
@@ -2,19 +2,36 @@
 #include <type_traits>
 #include <utility>
 
+#include "../deletion_queue.hpp"
 #include "../gl.h"
 
 namespace glpp::details {
+/**
+ * Tag to take ownership of an existing name
+ */
+struct Adopt {};
+
 template <typename Trait>
 class Object {
  public:
+  using ObjectTrait = Trait;
+
   Object() : id_{Trait::Create()} {}
 
+  Object(Adopt, GLuint id) : id_{id} {}
+
   Object(const Object &) = delete;
 
   Object(Object &&other) noexcept { std::swap(id_, other.id_); }
 
-  ~Object() { Trait::Delete(id_); }
+  ~Object() {
+    auto &queue = DeletionQueue::Get();
+    if (id_ != 0 && queue.IsDeferred()) {
+      queue.Push(static_cast<DeletionQueue::Deleter>(&Trait::Delete), id_);
+    } else {
+      Trait::Delete(id_);
+    }
+  }
 
   Object &operator=(const Object &) = delete;
 
@@ -27,6 +44,11 @@ class Object {
 
   [[nodiscard]] GLuint Id() const { return id_; }
 
+  /**
+   * Give up ownership of the name
+   */
+  GLuint Release() { return std::exchange(id_, 0U); }
+
   template <bool = true>
   void Bind() {
     Trait::Bind(id_);
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstring>
+
+#include "gl.h"
+
+// Extensions missing from the bundled GLAD
+#ifndef GL_ARB_sparse_buffer
+#define GL_SPARSE_STORAGE_BIT_ARB 0x0400
+#define GL_SPARSE_BUFFER_PAGE_SIZE_ARB 0x82F8
+#endif
+#ifndef GL_KHR_parallel_shader_compile
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace glpp {
+namespace details {
+struct Extensions {
+  using NamedBufferPageCommitmentARB = void(APIENTRYP)(GLuint, GLintptr,
+                                                       GLsizeiptr, GLboolean);
+
+  using MaxShaderCompilerThreadsKHR = void(APIENTRYP)(GLuint);
+
+  NamedBufferPageCommitmentARB named_buffer_page_commitment{nullptr};
+  MaxShaderCompilerThreadsKHR max_shader_compiler_threads{nullptr};
+  bool parallel_shader_compile{false};
+};
+
+inline Extensions extensions;
+}  // namespace details
+
+inline bool HasExtension(const char *name) {
+  GLint count;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for (GLint i = 0; i < count; ++i) {
+    const auto ext = reinterpret_cast<const char *>(
+        glGetStringi(GL_EXTENSIONS, GLuint(i)));
+    if (std::strcmp(ext, name) == 0) return true;
+  }
+  return false;
+}
+
+/**
+ * Load the entry points of supported extensions, after GLAD is loaded
+ */
+inline void LoadExtensions(GLADloadproc load) {
+  auto &ext = details::extensions;
+  ext = {};
+  if (HasExtension("GL_ARB_sparse_buffer")) {
+    ext.named_buffer_page_commitment =
+        reinterpret_cast<details::Extensions::NamedBufferPageCommitmentARB>(
+            load("glNamedBufferPageCommitmentARB"));
+  }
+  if (HasExtension("GL_KHR_parallel_shader_compile")) {
+    ext.parallel_shader_compile = true;
+    ext.max_shader_compiler_threads =
+        reinterpret_cast<details::Extensions::MaxShaderCompilerThreadsKHR>(
+            load("glMaxShaderCompilerThreadsKHR"));
+  } else if (HasExtension("GL_ARB_parallel_shader_compile")) {
+    ext.parallel_shader_compile = true;
+    ext.max_shader_compiler_threads =
+        reinterpret_cast<details::Extensions::MaxShaderCompilerThreadsKHR>(
+            load("glMaxShaderCompilerThreadsARB"));
+  }
+}
+}  // namespace glpp
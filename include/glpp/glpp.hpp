@@ -1,6 +1,29 @@
+#include "background_uploader.hpp"
 #include "buffer.hpp"
+#include "buffer_allocator.hpp"
+#include "deletion_queue.hpp"
+#include "extensions.hpp"
 #include "gl.h"
+#include "gpu_vector.hpp"
+#include "layout.hpp"
+#include "lz4_decompressor.hpp"
+#include "managed_buffer.hpp"
+#include "mirrored_buffer.hpp"
+#include "name_pool.hpp"
 #include "program.hpp"
+#include "program_cache.hpp"
+#include "program_pipeline.hpp"
+#include "program_queue.hpp"
+#include "readback.hpp"
 #include "shader.hpp"
+#include "shader_loader.hpp"
+#include "shader_reloader.hpp"
+#include "shader_variants.hpp"
+#include "sparse_buffer.hpp"
+#include "streaming_buffer.hpp"
+#include "sync.hpp"
 #include "texture.hpp"
+#include "typed_buffer.hpp"
+#include "uniform_block.hpp"
+#include "upload_queue.hpp"
 #include "vertexarray.hpp"
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "buffer.hpp"
+#include "gl.h"
+#include "vertexarray.hpp"
+
+namespace glpp {
+/**
+ * Growable array in GPU memory. Storage grows geometrically and the contents
+ * are moved with Buffer::CopySubData, never through the CPU. Bindings
+ * registered with OnReallocate(), BindVertexBuffer() or BindBase() are
+ * updated to the new buffer until removed with RemoveListener().
+ */
+template <typename T>
+class GpuVector {
+ public:
+  using Listener = std::function<void(Buffer &)>;
+
+  explicit GpuVector(std::size_t capacity = 16, GLbitfield flags = 0)
+      : flags_{flags | GL_DYNAMIC_STORAGE_BIT},
+        capacity_{std::max<std::size_t>(capacity, 1)} {
+    buffer_.CreateStorage(capacity_ * sizeof(T), nullptr, flags_);
+  }
+
+  void PushBack(const T &val) { Append(&val, 1); }
+
+  void Append(const T *data, std::size_t count) {
+    if (size_ + count > capacity_) {
+      Reallocate(std::max(size_ + count, capacity_ * 2));
+    }
+    buffer_.SetSubData(count * sizeof(T), data, size_ * sizeof(T));
+    size_ += count;
+  }
+
+  // For STL containers
+  template <typename Container>
+  void Append(const Container &arr) {
+    Append(arr.data(), arr.size());
+  }
+
+  void Set(std::size_t i, const T &val) {
+    if (i >= size_) throw std::out_of_range("GpuVector index out of range");
+    buffer_.SetSubData(sizeof(T), &val, i * sizeof(T));
+  }
+
+  /**
+   * New elements are left uninitialized
+   */
+  void Resize(std::size_t size) {
+    if (size > capacity_) Reallocate(std::max(size, capacity_ * 2));
+    size_ = size;
+  }
+
+  void Reserve(std::size_t capacity) {
+    if (capacity > capacity_) Reallocate(capacity);
+  }
+
+  void Clear() { size_ = 0; }
+
+  [[nodiscard]] std::size_t Size() const { return size_; }
+
+  [[nodiscard]] std::size_t Capacity() const { return capacity_; }
+
+  [[nodiscard]] Buffer &GetBuffer() { return buffer_; }
+
+  [[nodiscard]] const Buffer &GetBuffer() const { return buffer_; }
+
+  /**
+   * Call the listener with the new buffer whenever storage is reallocated.
+   * Returns a token for RemoveListener().
+   */
+  std::size_t OnReallocate(Listener listener) {
+    listeners_.emplace_back(++last_token_, std::move(listener));
+    return last_token_;
+  }
+
+  void RemoveListener(std::size_t token) {
+    listeners_.erase(
+        std::remove_if(listeners_.begin(), listeners_.end(),
+                       [token](const auto &l) { return l.first == token; }),
+        listeners_.end());
+  }
+
+  /**
+   * Bind as vertex buffer of the VAO, kept up to date across reallocations.
+   * The VAO may be moved, but the listener must be removed before the VAO is
+   * deleted since its name can be reused.
+   */
+  std::size_t BindVertexBuffer(const VertexArray &vao, GLuint binding_index,
+                               GLintptr offset = 0) {
+    Listener bind = [id = vao.Id(), binding_index, offset](Buffer &buffer) {
+      // Borrow the name without taking ownership of it
+      VertexArray vao{details::Adopt{}, id};
+      vao.BindVertexBuffer(binding_index, buffer, sizeof(T), offset);
+      vao.Release();
+    };
+    bind(buffer_);
+    return OnReallocate(std::move(bind));
+  }
+
+  /**
+   * Bind to an indexed target, kept up to date across reallocations
+   */
+  std::size_t BindBase(BufferTarget target, GLuint index) {
+    Listener bind = [target, index](Buffer &buffer) {
+      buffer.BindBase(target, index);
+    };
+    bind(buffer_);
+    return OnReallocate(std::move(bind));
+  }
+
+ private:
+  void Reallocate(std::size_t capacity) {
+    Buffer buffer;
+    buffer.CreateStorage(capacity * sizeof(T), nullptr, flags_);
+    if (size_ > 0) {
+      Buffer::CopySubData(buffer_, buffer, 0, 0, GLsizeiptr(size_ * sizeof(T)));
+    }
+    buffer_ = std::move(buffer);
+    capacity_ = capacity;
+    for (auto &[token, listener] : listeners_) listener(buffer_);
+  }
+
+  Buffer buffer_;
+  GLbitfield flags_;
+  std::size_t size_{0}, capacity_;
+  std::vector<std::pair<std::size_t, Listener>> listeners_;
+  std::size_t last_token_{0};
+};
+}  // namespace glpp
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <type_traits>
+
+#include "gl.h"
+
+namespace glpp {
+struct Std140 {};
+struct Std430 {};
+
+namespace details {
+constexpr std::size_t AlignUp(std::size_t size, std::size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * std140 rounds the alignment of arrays, matrix columns and structs up to vec4
+ */
+template <typename Layout>
+constexpr std::size_t ArrayAlignment(std::size_t alignment) {
+  return std::is_same_v<Layout, Std140> ? AlignUp(alignment, 16) : alignment;
+}
+
+/**
+ * Registered by GLPP_LAYOUT
+ */
+template <typename Layout, typename T>
+struct StructLayout {
+  static constexpr bool registered = false;
+};
+
+/**
+ * GLSL base alignment and size of T in the given layout
+ */
+template <typename Layout, typename T>
+struct LayoutTraits {
+  static_assert(StructLayout<Layout, T>::registered,
+                "Type not supported by the layout, register it with "
+                "GLPP_LAYOUT");
+
+  static constexpr std::size_t alignment = StructLayout<Layout, T>::alignment;
+  static constexpr std::size_t size = StructLayout<Layout, T>::size;
+};
+
+template <typename Layout, typename T>
+struct ScalarLayoutTraits {
+  static constexpr std::size_t alignment = sizeof(T);
+  static constexpr std::size_t size = sizeof(T);
+};
+
+template <typename Layout>
+struct LayoutTraits<Layout, float> : ScalarLayoutTraits<Layout, float> {};
+
+template <typename Layout>
+struct LayoutTraits<Layout, double> : ScalarLayoutTraits<Layout, double> {};
+
+template <typename Layout>
+struct LayoutTraits<Layout, GLint> : ScalarLayoutTraits<Layout, GLint> {};
+
+template <typename Layout>
+struct LayoutTraits<Layout, GLuint> : ScalarLayoutTraits<Layout, GLuint> {};
+
+template <typename Layout, glm::length_t L, typename T, glm::qualifier Q>
+struct LayoutTraits<Layout, glm::vec<L, T, Q>> {
+  static constexpr std::size_t alignment =
+      (L == 2 ? 2 : 4) * LayoutTraits<Layout, T>::size;
+  static constexpr std::size_t size = L * LayoutTraits<Layout, T>::size;
+};
+
+template <typename Layout, glm::length_t C, glm::length_t R, typename T,
+          glm::qualifier Q>
+struct LayoutTraits<Layout, glm::mat<C, R, T, Q>> {
+  static constexpr std::size_t alignment = ArrayAlignment<Layout>(
+      LayoutTraits<Layout, glm::vec<R, T, Q>>::alignment);
+  static constexpr std::size_t size = C * alignment;
+};
+
+template <typename Layout, typename T, std::size_t N>
+struct LayoutTraits<Layout, T[N]> {
+  static constexpr std::size_t alignment =
+      ArrayAlignment<Layout>(LayoutTraits<Layout, T>::alignment);
+  static constexpr std::size_t stride =
+      AlignUp(LayoutTraits<Layout, T>::size, alignment);
+  static constexpr std::size_t size = N * stride;
+
+  static_assert(sizeof(T) == stride,
+                "Array element size does not match the layout stride");
+};
+
+struct MemberLayout {
+  std::size_t offset, size, alignment, layout_size;
+};
+
+/**
+ * GLSL size of the struct, or 0 if any member is placed differently
+ */
+template <std::size_t N>
+constexpr std::size_t StructSize(const MemberLayout (&members)[N],
+                                 std::size_t alignment) {
+  std::size_t offset = 0;
+  for (const auto &m : members) {
+    offset = AlignUp(offset, m.alignment);
+    if (m.offset != offset || m.size != m.layout_size) return 0;
+    offset += m.layout_size;
+  }
+  return AlignUp(offset, alignment);
+}
+
+template <std::size_t N>
+constexpr std::size_t StructAlignment(const MemberLayout (&members)[N]) {
+  std::size_t alignment = 1;
+  for (const auto &m : members) {
+    if (m.alignment > alignment) alignment = m.alignment;
+  }
+  return alignment;
+}
+
+/**
+ * True if an array of T in C++ matches an array of T in the layout
+ */
+template <typename Layout, typename T>
+constexpr bool IsLayoutCompatible() {
+  return sizeof(T) == AlignUp(LayoutTraits<Layout, T>::size,
+                              LayoutTraits<Layout, T>::alignment);
+}
+}  // namespace details
+}  // namespace glpp
+
+#define GLPP_DETAILS_MEMBER(Layout, T, m)                                   \
+  ::glpp::details::MemberLayout {                                           \
+    offsetof(T, m), sizeof(T::m),                                           \
+        ::glpp::details::LayoutTraits<::glpp::Layout,                       \
+                                      decltype(T::m)>::alignment,           \
+        ::glpp::details::LayoutTraits<::glpp::Layout, decltype(T::m)>::size \
+  }
+
+#define GLPP_DETAILS_EXPAND(x) x
+#define GLPP_DETAILS_FOR_EACH_1(F, L, T, m) F(L, T, m)
+#define GLPP_DETAILS_FOR_EACH_2(F, L, T, m, ...) \
+  F(L, T, m), GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_1(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_3(F, L, T, m, ...) \
+  F(L, T, m), GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_2(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_4(F, L, T, m, ...) \
+  F(L, T, m), GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_3(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_5(F, L, T, m, ...) \
+  F(L, T, m), GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_4(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_6(F, L, T, m, ...) \
+  F(L, T, m), GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_5(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_7(F, L, T, m, ...) \
+  F(L, T, m), GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_6(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_8(F, L, T, m, ...) \
+  F(L, T, m), GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_7(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_9(F, L, T, m, ...) \
+  F(L, T, m), GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_8(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_10(F, L, T, m, ...) \
+  F(L, T, m), GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_9(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_11(F, L, T, m, ...) \
+  F(L, T, m),                                     \
+      GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_10(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_12(F, L, T, m, ...) \
+  F(L, T, m),                                     \
+      GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_11(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_13(F, L, T, m, ...) \
+  F(L, T, m),                                     \
+      GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_12(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_14(F, L, T, m, ...) \
+  F(L, T, m),                                     \
+      GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_13(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_15(F, L, T, m, ...) \
+  F(L, T, m),                                     \
+      GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_14(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_16(F, L, T, m, ...) \
+  F(L, T, m),                                     \
+      GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_15(F, L, T, __VA_ARGS__))
+#define GLPP_DETAILS_FOR_EACH_N(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, \
+                                _12, _13, _14, _15, _16, NAME, ...)           \
+  NAME
+#define GLPP_DETAILS_FOR_EACH(F, L, T, ...)                                   \
+  GLPP_DETAILS_EXPAND(GLPP_DETAILS_FOR_EACH_N(                                \
+      __VA_ARGS__, GLPP_DETAILS_FOR_EACH_16, GLPP_DETAILS_FOR_EACH_15,        \
+      GLPP_DETAILS_FOR_EACH_14, GLPP_DETAILS_FOR_EACH_13,                     \
+      GLPP_DETAILS_FOR_EACH_12, GLPP_DETAILS_FOR_EACH_11,                     \
+      GLPP_DETAILS_FOR_EACH_10, GLPP_DETAILS_FOR_EACH_9,                      \
+      GLPP_DETAILS_FOR_EACH_8, GLPP_DETAILS_FOR_EACH_7,                       \
+      GLPP_DETAILS_FOR_EACH_6, GLPP_DETAILS_FOR_EACH_5,                       \
+      GLPP_DETAILS_FOR_EACH_4, GLPP_DETAILS_FOR_EACH_3,                       \
+      GLPP_DETAILS_FOR_EACH_2, GLPP_DETAILS_FOR_EACH_1)(F, L, T, __VA_ARGS__))
+
+/**
+ * Register the members of struct T, in declaration order, and check at compile
+ * time that they are placed as in the Std140/Std430 layout. Use at global
+ * scope.
+ */
+#define GLPP_LAYOUT(Layout, T, ...)                                          \
+  template <>                                                                \
+  struct glpp::details::StructLayout<glpp::Layout, T> {                      \
+    static constexpr bool registered = true;                                 \
+    static constexpr MemberLayout members[] = {                              \
+        GLPP_DETAILS_FOR_EACH(GLPP_DETAILS_MEMBER, Layout, T, __VA_ARGS__)}; \
+    static constexpr std::size_t alignment =                                 \
+        ArrayAlignment<glpp::Layout>(StructAlignment(members));              \
+    static constexpr std::size_t size =                                      \
+        StructSize(members, alignment);                                      \
+    static_assert(size != 0, #T " members do not match " #Layout);           \
+    static_assert(sizeof(T) == size, #T " size does not match " #Layout);    \
+  }
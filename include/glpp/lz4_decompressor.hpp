@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "buffer.hpp"
+#include "gl.h"
+#include "layout.hpp"
+#include "program.hpp"
+#include "shader.hpp"
+
+namespace glpp {
+/**
+ * An independently compressed LZ4 block, in raw block format
+ */
+struct Lz4Block {
+  GLuint src_offset;  // In the compressed data
+  GLuint src_size;
+  GLuint dst_offset;  // From the destination offset, multiple of 4
+  GLuint dst_size;
+};
+}  // namespace glpp
+
+GLPP_LAYOUT(Std430, glpp::Lz4Block, src_offset, src_size, dst_offset,
+            dst_size);
+
+namespace glpp {
+/**
+ * Expand LZ4 compressed data on the GPU, one invocation per block.
+ * Uses shader storage bindings 0 to 2 and leaves its program in use.
+ */
+class Lz4Decompressor {
+  static_assert(details::IsLayoutCompatible<Std430, Lz4Block>(),
+                "Block table does not match the std430 layout");
+
+ public:
+  Lz4Decompressor() : program_{ComputeShader{kSource}} {}
+
+  /**
+   * Decompress the blocks into dst starting at dst_offset, a multiple of 4.
+   * dst is bound as a uint array so its size should be a multiple of 4 too.
+   * Bytes after a block that does not end on a multiple of 4 are preserved.
+   * barriers are the glMemoryBarrier bits for how dst is read next, e.g.
+   * GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT for vertex data.
+   */
+  void Decompress(const void *compressed, GLsizeiptr size,
+                  std::vector<Lz4Block> blocks, Buffer &dst,
+                  GLintptr dst_offset = 0,
+                  GLbitfield barriers = GL_SHADER_STORAGE_BARRIER_BIT) {
+    if (blocks.empty()) return;
+    if (dst_offset % 4 != 0) {
+      throw std::invalid_argument("LZ4 destination offset not 4-aligned");
+    }
+    GLint64 dst_size;
+    glGetNamedBufferParameteri64v(dst.Id(), GL_BUFFER_SIZE, &dst_size);
+    for (auto &block : blocks) {
+      if (block.dst_offset % 4 != 0) {
+        throw std::invalid_argument("LZ4 block offset not 4-aligned");
+      }
+      block.dst_offset += GLuint(dst_offset);
+      if (GLint64(block.dst_offset) + block.dst_size > dst_size) {
+        throw std::out_of_range("LZ4 block past the end of the destination");
+      }
+    }
+
+    Reserve(src_, src_capacity_, (size + 3) / 4 * 4);
+    src_.SetSubData(size, compressed);
+    Reserve(table_, table_capacity_,
+            GLsizeiptr(blocks.size() * sizeof(Lz4Block)));
+    table_.SetSubData(GLsizeiptr(blocks.size() * sizeof(Lz4Block)),
+                      blocks.data());
+
+    src_.BindBase(BufferTarget::SHADER_STORAGE_BUFFER, 0);
+    table_.BindBase(BufferTarget::SHADER_STORAGE_BUFFER, 1);
+    dst.BindBase(BufferTarget::SHADER_STORAGE_BUFFER, 2);
+    program_.Use();
+    glDispatchCompute(GLuint(blocks.size() + kGroupSize - 1) / kGroupSize, 1,
+                      1);
+    glMemoryBarrier(barriers);
+  }
+
+ private:
+  static constexpr GLuint kGroupSize = 64;
+
+  /**
+   * Staging buffers are kept between calls and grown geometrically
+   */
+  static void Reserve(Buffer &buffer, GLsizeiptr &capacity, GLsizeiptr size) {
+    if (size <= capacity) return;
+    capacity = std::max(size, capacity * 2);
+    buffer = Buffer();
+    buffer.CreateStorage(capacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+  }
+
+  static constexpr const char *kSource = R"(
+#version 450
+layout(local_size_x = 64) in;
+
+struct Block {
+  uint src_offset;
+  uint src_size;
+  uint dst_offset;
+  uint dst_size;
+};
+
+layout(std430, binding = 0) readonly buffer compressed { uint src[]; };
+layout(std430, binding = 1) readonly buffer block_table { Block blocks[]; };
+layout(std430, binding = 2) buffer decompressed { uint dst[]; };
+
+// Output is buffered one word at a time, blocks never share a word
+uint op;
+uint op_word;
+
+uint ReadSrc(uint i) { return (src[i >> 2] >> ((i & 3u) << 3)) & 0xFFu; }
+
+uint ReadDst(uint i) {
+  const uint word = (i >> 2) == (op >> 2) ? op_word : dst[i >> 2];
+  return (word >> ((i & 3u) << 3)) & 0xFFu;
+}
+
+void WriteDst(uint v) {
+  op_word |= v << ((op & 3u) << 3);
+  if ((op & 3u) == 3u) {
+    dst[op >> 2] = op_word;
+    op_word = 0u;
+  }
+  ++op;
+}
+
+uint ReadLength(uint len, inout uint ip, uint ip_end) {
+  if (len == 15u) {
+    uint s = 255u;
+    while (s == 255u && ip < ip_end) {
+      s = ReadSrc(ip++);
+      len += s;
+    }
+  }
+  return len;
+}
+
+void main() {
+  const uint id = gl_GlobalInvocationID.x;
+  if (id >= blocks.length()) return;
+  const Block block = blocks[id];
+
+  uint ip = block.src_offset;
+  const uint ip_end = block.src_offset + block.src_size;
+  const uint op_end = block.dst_offset + block.dst_size;
+  op = block.dst_offset;
+  op_word = 0u;
+
+  while (ip < ip_end) {
+    const uint token = ReadSrc(ip++);
+    const uint literals = ReadLength(token >> 4, ip, ip_end);
+    for (uint i = 0u; i < literals && op < op_end; ++i) {
+      WriteDst(ReadSrc(ip + i));
+    }
+    ip += literals;
+    if (ip >= ip_end) break;
+
+    const uint match_offset = ReadSrc(ip) | (ReadSrc(ip + 1u) << 8);
+    ip += 2u;
+    const uint match = ReadLength(token & 15u, ip, ip_end) + 4u;
+    for (uint i = 0u; i < match && op < op_end; ++i) {
+      WriteDst(ReadDst(op - match_offset));
+    }
+  }
+  if ((op & 3u) != 0u) {
+    // Keep the bytes past the end of the block
+    const uint kept = dst[op >> 2] & (~0u << ((op & 3u) << 3));
+    dst[op >> 2] = kept | op_word;
+  }
+}
+)";
+
+  Program program_;
+  Buffer src_, table_;
+  GLsizeiptr src_capacity_{0}, table_capacity_{0};
+};
+}  // namespace glpp
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "buffer.hpp"
+#include "gl.h"
+#include "streaming_buffer.hpp"
+
+namespace glpp {
+enum class BufferUsage {
+  STATIC,    // Written once at creation
+  STREAM,    // Updated by the CPU every frame
+  READBACK,  // Written by the GPU, read by the CPU
+  SCRATCH    // Only accessed by the GPU
+};
+
+enum class UpdateStrategy {
+  SUB_DATA,        // glNamedBufferSubData
+  PERSISTENT_MAP,  // memcpy into a fenced mapped ring and copy on the GPU
+  COPY             // Upload into a reused staging buffer and copy on the GPU
+};
+
+struct BufferPolicy {
+  GLbitfield storage_flags;
+  GLbitfield map_flags;  // Persistently mapped at creation if nonzero
+  UpdateStrategy update;
+};
+
+/**
+ * Policy used by buffers created afterwards with the given usage. Mutable so
+ * that upload paths can be tuned per driver in one place.
+ */
+inline BufferPolicy &GetBufferPolicy(BufferUsage usage) {
+  constexpr GLbitfield read_map =
+      GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  static BufferPolicy policies[] = {
+      {0, 0, UpdateStrategy::COPY},
+      {0, 0, UpdateStrategy::PERSISTENT_MAP},
+      {read_map | GL_CLIENT_STORAGE_BIT, read_map, UpdateStrategy::COPY},
+      {0, 0, UpdateStrategy::COPY}};
+  return policies[static_cast<int>(usage)];
+}
+
+struct BufferUsageStats {
+  std::size_t updates{0}, reads{0}, contradictions{0};
+};
+
+/**
+ * Buffer whose storage flags and update path follow its declared usage.
+ * Accesses contradicting the usage still work but are counted and logged.
+ */
+class ManagedBuffer : public Buffer {
+ public:
+  ManagedBuffer(BufferUsage usage, GLsizeiptr size, const void *data = nullptr)
+      : usage_{usage}, policy_{GetBufferPolicy(usage)}, size_{size} {
+    CreateStorage(size, data, policy_.storage_flags);
+    if (policy_.map_flags) {
+      mapped_ = static_cast<unsigned char *>(
+          MapRange(0, size, policy_.map_flags));
+    }
+  }
+
+  // For STL containers
+  template <typename Container,
+            typename = decltype(std::declval<const Container &>().data())>
+  ManagedBuffer(BufferUsage usage, const Container &arr)
+      : ManagedBuffer(usage,
+                      arr.size() * sizeof(typename Container::value_type),
+                      arr.data()) {}
+
+  void Update(GLsizeiptr size, const void *data, GLintptr offset = 0) {
+    if (offset < 0 || size < 0 || offset + size > size_) {
+      throw std::out_of_range("Buffer update out of range");
+    }
+    ++stats_.updates;
+    if (usage_ != BufferUsage::STREAM) Contradict("updated by the CPU");
+
+    switch (policy_.update) {
+      case UpdateStrategy::SUB_DATA:
+        SetSubData(size, data, offset);
+        break;
+      case UpdateStrategy::PERSISTENT_MAP:
+        UpdateMapped(size, data, offset);
+        break;
+      case UpdateStrategy::COPY:
+        if (!staging_ || size > staging_size_) {
+          staging_ = std::make_unique<Buffer>();
+          staging_->CreateStorage(size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+          staging_size_ = size;
+        }
+        staging_->SetSubData(size, data);
+        CopySubData(*staging_, *this, 0, offset, size);
+        break;
+    }
+  }
+
+  // For STL containers
+  template <typename Container,
+            typename = decltype(std::declval<const Container &>().data())>
+  void Update(const Container &arr, GLintptr offset = 0) {
+    Update(arr.size() * sizeof(typename Container::value_type), arr.data(),
+           offset);
+  }
+
+  /**
+   * Read back a range. GPU writes must be fenced by the caller beforehand.
+   */
+  void Read(GLsizeiptr size, void *data, GLintptr offset = 0) {
+    ++stats_.reads;
+    if (usage_ != BufferUsage::READBACK) Contradict("read by the CPU");
+
+    if (mapped_ && (policy_.map_flags & GL_MAP_READ_BIT)) {
+      std::memcpy(data, mapped_ + offset, size);
+    } else {
+      glGetNamedBufferSubData(Id(), offset, size, data);
+    }
+  }
+
+  [[nodiscard]] BufferUsage Usage() const { return usage_; }
+
+  [[nodiscard]] GLsizeiptr Size() const { return size_; }
+
+  [[nodiscard]] const BufferUsageStats &Stats() const { return stats_; }
+
+ private:
+  /**
+   * Updates are packed into the current region of the ring, which is only
+   * fenced and left once full, so small updates rarely wait
+   */
+  void UpdateMapped(GLsizeiptr size, const void *data, GLintptr offset) {
+    // Created on first use, each region fits a whole-buffer update
+    if (!ring_) ring_ = std::make_unique<StreamingBuffer>(size_);
+    if (!region_.data || ring_used_ + size > region_.size) {
+      if (region_.data) ring_->Release();
+      region_ = ring_->Acquire();
+      ring_used_ = 0;
+    }
+    std::memcpy(static_cast<unsigned char *>(region_.data) + ring_used_, data,
+                size);
+    CopySubData(ring_->GetBuffer(), *this, region_.offset + ring_used_, offset,
+                size);
+    ring_used_ += size;
+  }
+
+  void Contradict(const char *access) {
+    if (stats_.contradictions++ > 0) return;
+    static const char *names[] = {"STATIC", "STREAM", "READBACK", "SCRATCH"};
+    std::clog << "Buffer " << Id() << " declared "
+              << names[static_cast<int>(usage_)] << " but " << access
+              << std::endl;
+  }
+
+  BufferUsage usage_;
+  BufferPolicy policy_;
+  GLsizeiptr size_;
+  unsigned char *mapped_{nullptr};
+  std::unique_ptr<StreamingBuffer> ring_;
+  StreamingBuffer::Region region_{};
+  GLsizeiptr ring_used_{0};
+  std::unique_ptr<Buffer> staging_;
+  GLsizeiptr staging_size_{0};
+  BufferUsageStats stats_;
+};
+}  // namespace glpp
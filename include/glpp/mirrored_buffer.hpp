@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "buffer.hpp"
+#include "gl.h"
+
+namespace glpp {
+/**
+ * CPU copy of a buffer that tracks modified elements and only uploads those.
+ * Once more than full_upload_ratio of the elements changed, the whole buffer
+ * is invalidated and uploaded at once instead.
+ */
+template <typename T>
+class MirroredBuffer {
+ public:
+  explicit MirroredBuffer(std::vector<T> data, float full_upload_ratio = .5f)
+      : data_(std::move(data)), full_upload_ratio_{full_upload_ratio} {
+    buffer_.CreateStorage(data_, GL_DYNAMIC_STORAGE_BIT);
+  }
+
+  const T &operator[](std::size_t i) const { return data_[i]; }
+
+  /**
+   * Mark the element dirty and return it for writing
+   */
+  T &Modify(std::size_t i) {
+    MarkDirty(i, 1);
+    return data_[i];
+  }
+
+  void Set(std::size_t i, const T &val) { Modify(i) = val; }
+
+  void MarkDirty(std::size_t first, std::size_t count) {
+    if (!dirty_.empty()) {
+      auto &last = dirty_.back();
+      if (first <= last.second && first + count >= last.first) {
+        last = {std::min(first, last.first),
+                std::max(first + count, last.second)};
+        return;
+      }
+    }
+    dirty_.emplace_back(first, first + count);
+  }
+
+  /**
+   * Upload the dirty ranges, returning the number of elements uploaded
+   */
+  std::size_t Sync() {
+    if (dirty_.empty()) return 0;
+
+    std::sort(dirty_.begin(), dirty_.end());
+    std::size_t merged = 0, total = 0;
+    for (std::size_t i = 1; i < dirty_.size(); ++i) {
+      if (dirty_[i].first <= dirty_[merged].second) {
+        dirty_[merged].second =
+            std::max(dirty_[merged].second, dirty_[i].second);
+      } else {
+        dirty_[++merged] = dirty_[i];
+      }
+    }
+    dirty_.resize(merged + 1);
+    for (const auto &[first, last] : dirty_) total += last - first;
+
+    if (total > full_upload_ratio_ * data_.size()) {
+      buffer_.InvalidateData();
+      buffer_.SetSubData(data_);
+      total = data_.size();
+    } else {
+      for (const auto &[first, last] : dirty_) {
+        buffer_.SetSubData((last - first) * sizeof(T), data_.data() + first,
+                           first * sizeof(T));
+      }
+    }
+    dirty_.clear();
+    return total;
+  }
+
+  [[nodiscard]] const std::vector<T> &Data() const { return data_; }
+
+  [[nodiscard]] std::size_t Size() const { return data_.size(); }
+
+  [[nodiscard]] Buffer &GetBuffer() { return buffer_; }
+
+  [[nodiscard]] const Buffer &GetBuffer() const { return buffer_; }
+
+ private:
+  Buffer buffer_;
+  std::vector<T> data_;
+  float full_upload_ratio_;
+  std::vector<std::pair<std::size_t, std::size_t>> dirty_;
+};
+}  // namespace glpp
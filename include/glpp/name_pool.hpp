@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "deletion_queue.hpp"
+#include "details/object.hpp"
+#include "gl.h"
+
+namespace glpp {
+namespace details {
+/**
+ * Flush functions of the name pools used by this thread
+ */
+inline std::vector<void (*)()> &ThreadNamePools() {
+  thread_local std::vector<void (*)()> pools;
+  return pools;
+}
+
+/**
+ * Hands out names created with Trait::Create(n, ids) in batches. Released
+ * names are deleted at once so that their storage is freed. One pool per
+ * thread, as GL contexts are. With the default batch size of 1 it behaves
+ * like plain create/delete.
+ */
+template <typename Trait>
+class NamePool {
+ public:
+  static NamePool &Get() {
+    thread_local NamePool pool;
+    return pool;
+  }
+
+  void SetBatchSize(GLsizei size) { batch_size_ = size > 0 ? size : 1; }
+
+  GLuint Acquire() {
+    if (free_.empty()) {
+      free_.resize(batch_size_);
+      Trait::Create(batch_size_, free_.data());
+    }
+    const auto id = free_.back();
+    free_.pop_back();
+    return id;
+  }
+
+  void Release(GLuint id) {
+    if (id != 0) Trait::Delete(1, &id);
+  }
+
+  /**
+   * Delete the names created ahead but not handed out yet
+   */
+  void Flush() {
+    if (free_.empty()) return;
+    Trait::Delete(GLsizei(free_.size()), free_.data());
+    free_.clear();
+  }
+
+ private:
+  NamePool() {
+    ThreadNamePools().push_back([] { Get().Flush(); });
+  }
+
+  GLsizei batch_size_{1};
+  std::vector<GLuint> free_;
+};
+}  // namespace details
+
+/**
+ * Create names for T in batches of size on this thread
+ */
+template <typename T>
+void SetNameBatchSize(GLsizei size) {
+  details::NamePool<typename T::ObjectTrait>::Get().SetBatchSize(size);
+}
+
+template <typename T>
+void FlushNames() {
+  details::NamePool<typename T::ObjectTrait>::Get().Flush();
+}
+
+/**
+ * Delete the names created ahead by every pool of this thread. Must be
+ * called while the context is still current, before the thread exits or
+ * the context is destroyed, or they leak.
+ */
+inline void FlushNames() {
+  for (const auto flush : details::ThreadNamePools()) flush();
+}
+
+/**
+ * N objects created and deleted with one call each
+ */
+template <typename T, std::size_t N>
+class ObjectArray {
+  static_assert(N > 0, "Empty object array");
+
+  using Trait = typename T::ObjectTrait;
+
+ public:
+  ObjectArray() : ObjectArray(CreateNames(), std::make_index_sequence<N>{}) {}
+
+  ObjectArray(ObjectArray &&) noexcept = default;
+
+  ObjectArray &operator=(ObjectArray &&) noexcept = default;
+
+  ~ObjectArray() {
+    std::vector<GLuint> ids(N);
+    for (std::size_t i = 0; i < N; ++i) ids[i] = objects_[i].Release();
+    if (ids[0] == 0) return;  // Moved from
+    auto &queue = DeletionQueue::Get();
+    if (queue.IsDeferred()) {
+      queue.Push(static_cast<DeletionQueue::BatchDeleter>(&Trait::Delete),
+                 std::move(ids));
+    } else {
+      Trait::Delete(GLsizei(N), ids.data());
+    }
+  }
+
+  T &operator[](std::size_t i) { return objects_[i]; }
+
+  const T &operator[](std::size_t i) const { return objects_[i]; }
+
+  auto begin() { return objects_.begin(); }
+
+  auto end() { return objects_.end(); }
+
+  [[nodiscard]] static constexpr std::size_t size() { return N; }
+
+ private:
+  static std::array<GLuint, N> CreateNames() {
+    std::array<GLuint, N> ids;
+    Trait::Create(GLsizei(N), ids.data());
+    return ids;
+  }
+
+  template <std::size_t... I>
+  ObjectArray(const std::array<GLuint, N> &ids, std::index_sequence<I...>)
+      : objects_{{T(details::Adopt{}, ids[I])...}} {}
+
+  std::array<T, N> objects_;
+};
+}  // namespace glpp
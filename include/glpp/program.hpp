@@ -1,14 +1,23 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 #include "details/object.hpp"
+#include "extensions.hpp"
 #include "gl.h"
+#include "shader.hpp"
 
 namespace glpp {
 namespace details {
@@ -17,8 +26,131 @@ struct ProgramTrait {
 
   static void Delete(GLuint id) { glDeleteProgram(id); }
 };
+
+/**
+ * Upload of count uniforms of type T, specialized below
+ */
+template <typename T>
+struct UniformSetter {
+  static_assert(sizeof(T) == 0, "Uniform type not supported");
+};
+
+inline bool IsOpaqueType(GLenum type) {
+  const auto in = [type](GLenum first, GLenum last) {
+    return type >= first && type <= last;
+  };
+  return in(GL_SAMPLER_1D, GL_SAMPLER_2D_RECT_SHADOW) ||
+         in(GL_SAMPLER_1D_ARRAY, GL_SAMPLER_CUBE_SHADOW) ||
+         in(GL_INT_SAMPLER_1D, GL_UNSIGNED_INT_SAMPLER_BUFFER) ||
+         in(GL_SAMPLER_CUBE_MAP_ARRAY,
+            GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY) ||
+         in(GL_IMAGE_1D, GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY) ||
+         in(GL_SAMPLER_2D_MULTISAMPLE,
+            GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY);
+}
+
+/**
+ * Bytes of a uniform of the GL type, 0 if not settable
+ */
+inline std::size_t UniformTypeSize(GLenum type) {
+  switch (type) {
+    case GL_FLOAT:
+    case GL_INT:
+    case GL_UNSIGNED_INT:
+    case GL_BOOL:
+      return 4;
+    case GL_FLOAT_VEC2:
+    case GL_INT_VEC2:
+    case GL_UNSIGNED_INT_VEC2:
+    case GL_DOUBLE:
+      return 8;
+    case GL_FLOAT_VEC3:
+    case GL_INT_VEC3:
+    case GL_UNSIGNED_INT_VEC3:
+      return 12;
+    case GL_FLOAT_VEC4:
+    case GL_INT_VEC4:
+    case GL_UNSIGNED_INT_VEC4:
+    case GL_DOUBLE_VEC2:
+    case GL_FLOAT_MAT2:
+      return 16;
+    case GL_DOUBLE_VEC3:
+    case GL_FLOAT_MAT2x3:
+    case GL_FLOAT_MAT3x2:
+      return 24;
+    case GL_DOUBLE_VEC4:
+    case GL_FLOAT_MAT2x4:
+    case GL_FLOAT_MAT4x2:
+    case GL_DOUBLE_MAT2:
+      return 32;
+    case GL_FLOAT_MAT3:
+      return 36;
+    case GL_FLOAT_MAT3x4:
+    case GL_FLOAT_MAT4x3:
+    case GL_DOUBLE_MAT2x3:
+    case GL_DOUBLE_MAT3x2:
+      return 48;
+    case GL_FLOAT_MAT4:
+    case GL_DOUBLE_MAT2x4:
+    case GL_DOUBLE_MAT4x2:
+      return 64;
+    case GL_DOUBLE_MAT3:
+      return 72;
+    case GL_DOUBLE_MAT3x4:
+    case GL_DOUBLE_MAT4x3:
+      return 96;
+    case GL_DOUBLE_MAT4:
+      return 128;
+    default:
+      return IsOpaqueType(type) ? 4 : 0;
+  }
+}
+
+/**
+ * Whether a uniform declared with the GL type can be set from T
+ */
+template <typename T>
+bool UniformTypeMatches(GLenum type) {
+  if (type == UniformSetter<T>::type) return true;
+  if constexpr (std::is_same_v<typename UniformSetter<T>::element_type, int>) {
+    return type == GL_BOOL || IsOpaqueType(type);
+  }
+  return false;
+}
 }  // namespace details
 
+template <typename T>
+class UniformHandle;
+
+/**
+ * Uniform, attribute or output reflected at link time
+ */
+struct ProgramVariable {
+  GLint location;
+  GLenum type;
+  GLint size;  // Array size, 1 otherwise
+};
+
+/**
+ * Interface block reflected at link time
+ */
+struct ProgramBlock {
+  GLuint index;
+  GLint binding;
+  GLint size;                                      // Minimum buffer size
+  std::unordered_map<std::string, GLint> offsets;  // Of the members
+};
+
+struct UniformUpdateStats {
+  std::size_t issued{0}, skipped{0};
+};
+
+struct ProgramBinary {
+  GLenum format;
+  std::vector<char> data;
+  bool compute{false};  // Has a compute stage, not queryable from a binary
+};
+
 class Program : public details::Object<details::ProgramTrait> {
  public:
   Program() = default;
@@ -30,6 +162,23 @@ class Program : public details::Object<details::ProgramTrait> {
     Detach(s...);
   }
 
+  /**
+   * Program usable in a ProgramPipeline, usually from a single stage
+   */
+  template <typename... Shaders>
+  static Program Separable(const Shaders &... s) {
+    Program program;
+    program.Parameter(GL_PROGRAM_SEPARABLE, GL_TRUE);
+    program.Attach(s...);
+    program.Link();
+    program.Detach(s...);
+    return program;
+  }
+
+  [[nodiscard]] bool IsSeparable() {
+    return GetParam(GL_PROGRAM_SEPARABLE) == GL_TRUE;
+  }
+
   void Use() { glUseProgram(Id()); }
 
   template <typename... Shaders>
@@ -45,8 +194,38 @@ class Program : public details::Object<details::ProgramTrait> {
   }
 
   void Link() {
+    LinkAsync();
+    FinishLink();
+  }
+
+  /**
+   * Compile the stages, link them and detach them
+   */
+  void Link(const std::vector<ShaderSource> &sources) {
+    LinkStages(sources.data(), sources.data() + sources.size());
+  }
+
+  /**
+   * Start linking without waiting for the result
+   */
+  void LinkAsync() {
+    compute_ = HasComputeStage();
     glLinkProgram(Id());
+  }
 
+  /**
+   * Whether the result is available without blocking. Always true without
+   * KHR_parallel_shader_compile.
+   */
+  [[nodiscard]] bool IsLinkComplete() {
+    if (!details::extensions.parallel_shader_compile) return true;
+    return GetParam(GL_COMPLETION_STATUS_KHR) == GL_TRUE;
+  }
+
+  /**
+   * Wait for the link, log and throw on error, then reflect the interface
+   */
+  void FinishLink() {
     // Check the program.
     const auto log_length = GetParam(GL_INFO_LOG_LENGTH);
     if (log_length > 0) {
@@ -58,13 +237,41 @@ class Program : public details::Object<details::ProgramTrait> {
     if (GetParam(GL_LINK_STATUS) != GL_TRUE) {
       throw std::runtime_error("Program link error");
     }
+    Reflect();
+  }
 
-    uniform_locs_ =
-        GetLocations<GL_ACTIVE_UNIFORMS, GL_ACTIVE_UNIFORM_MAX_LENGTH>(
-            glGetActiveUniform, glGetUniformLocation);
-    attrib_locs_ =
-        GetLocations<GL_ACTIVE_ATTRIBUTES, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH>(
-            glGetActiveAttrib, glGetAttribLocation);
+  /**
+   * Program parameter such as GL_PROGRAM_SEPARABLE, set before linking
+   */
+  void Parameter(GLenum pname, GLint value) {
+    glProgramParameteri(Id(), pname, value);
+  }
+
+  /**
+   * Linked binary, retrievable if the hint was set before linking
+   */
+  ProgramBinary GetBinary() {
+    ProgramBinary binary{0, {}};
+    binary.data.resize(GetParam(GL_PROGRAM_BINARY_LENGTH));
+    GLsizei length = 0;
+    glGetProgramBinary(Id(), GLsizei(binary.data.size()), &length,
+                       &binary.format, binary.data.data());
+    binary.data.resize(length);
+    binary.compute = compute_;
+    return binary;
+  }
+
+  /**
+   * Replace the program by a binary from GetBinary(). Returns false if it was
+   * rejected, e.g. after a driver update; the program must then be relinked.
+   */
+  bool LoadBinary(const ProgramBinary &binary) {
+    glProgramBinary(Id(), binary.format, binary.data.data(),
+                    GLsizei(binary.data.size()));
+    if (GetParam(GL_LINK_STATUS) != GL_TRUE) return false;
+    compute_ = binary.compute;
+    Reflect();
+    return true;
   }
 
   GLint GetParam(GLenum pname) {
@@ -73,32 +280,296 @@ class Program : public details::Object<details::ProgramTrait> {
     return ret;
   }
 
-  GLint UniformLoc(const std::string &name) { return uniform_locs_.at(name); }
+  GLint UniformLoc(const std::string &name) {
+    return uniform_locs_.at(name).location;
+  }
 
   template <typename... Names>
   auto UniformLoc(const std::string &name, const Names &... names) {
-    return std::make_tuple(uniform_locs_.at(name), uniform_locs_.at(names)...);
+    return std::make_tuple(UniformLoc(name), UniformLoc(names)...);
   }
 
-  GLint AttribLoc(const std::string &name) { return attrib_locs_.at(name); }
+  GLint AttribLoc(const std::string &name) {
+    return attrib_locs_.at(name).location;
+  }
 
   template <typename... Names>
   auto AttribLoc(const std::string &name, const Names &... names) {
-    return std::make_tuple(attrib_locs_.at(name), attrib_locs_.at(names)...);
+    return std::make_tuple(AttribLoc(name), AttribLoc(names)...);
+  }
+
+  [[nodiscard]] const ProgramBlock &GetUniformBlock(
+      const std::string &name) const {
+    return uniform_blocks_.at(name);
+  }
+
+  /**
+   * Source the named uniform block from the UNIFORM_BUFFER binding
+   */
+  void UniformBlockBinding(const std::string &name, GLuint binding) {
+    auto &block = uniform_blocks_.at(name);
+    glUniformBlockBinding(Id(), block.index, binding);
+    block.binding = GLint(binding);
+  }
+
+  /**
+   * Storage block, with the offsets of its buffer variables
+   */
+  [[nodiscard]] const ProgramBlock &GetStorageBlock(
+      const std::string &name) const {
+    return storage_blocks_.at(name);
+  }
+
+  /**
+   * Source the named storage block from the SHADER_STORAGE_BUFFER binding
+   */
+  void ShaderStorageBlockBinding(const std::string &name, GLuint binding) {
+    auto &block = storage_blocks_.at(name);
+    glShaderStorageBlockBinding(Id(), block.index, binding);
+    block.binding = GLint(binding);
+  }
+
+  [[nodiscard]] const ProgramVariable &GetOutput(
+      const std::string &name) const {
+    return outputs_.at(name);
+  }
+
+  using Variables = std::unordered_map<std::string, ProgramVariable>;
+  using Blocks = std::unordered_map<std::string, ProgramBlock>;
+
+  [[nodiscard]] const Variables &Uniforms() const { return uniform_locs_; }
+
+  [[nodiscard]] const Variables &Attributes() const { return attrib_locs_; }
+
+  [[nodiscard]] const Variables &Outputs() const { return outputs_; }
+
+  [[nodiscard]] const Blocks &UniformBlocks() const { return uniform_blocks_; }
+
+  [[nodiscard]] const Blocks &StorageBlocks() const { return storage_blocks_; }
+
+  /**
+   * Local size of a compute program, zeros otherwise. A program loaded from
+   * a binary is only known to be a compute program through
+   * ProgramBinary::compute.
+   */
+  [[nodiscard]] const std::array<GLint, 3> &WorkGroupSize() const {
+    return work_group_size_;
+  }
+
+  template <typename T>
+  void Uniform(const std::string &name, const T &val) {
+    Uniform(UniformLoc(name), val);
+  }
+
+  /**
+   * Also accepts arrays, std::array and std::vector, uploaded in one call
+   */
+  template <typename T>
+  void Uniform(GLint location, const T &val) {
+    using Element = typename details::UniformSetter<T>::element_type;
+    if constexpr (std::is_same_v<T, Element>) {
+      Uniform(location, &val, 1);
+    } else {
+      Uniform(location, std::data(val), GLsizei(std::size(val)));
+    }
+  }
+
+  template <typename T>
+  void Uniform(const std::string &name, const T *data, GLsizei count) {
+    Uniform(UniformLoc(name), data, count);
+  }
+
+  template <typename T>
+  void Uniform(GLint location, const T *data, GLsizei count) {
+    if (!shadow_slots_.empty() &&
+        !UpdateShadow(location, data, count * sizeof(T))) {
+      ++uniform_stats_.skipped;
+      return;
+    }
+    ++uniform_stats_.issued;
+    details::UniformSetter<T>::Set(Id(), location, count, data);
+  }
+
+  /**
+   * Keep a copy of the uniform values, allocated at link time, and skip
+   * updates that do not change them. Values set through other paths than
+   * Uniform() are not seen.
+   */
+  void ShadowUniforms(bool enable) {
+    shadowed_ = enable;
+    AllocateShadow();
+  }
+
+  [[nodiscard]] const UniformUpdateStats &UniformStats() const {
+    return uniform_stats_;
   }
 
+  /**
+   * Handle setting the uniform by location, checked against its GL type
+   */
   template <typename T>
-  void Uniform(const std::string &name, const T &val);
+  UniformHandle<T> GetUniform(const std::string &name);
 
  private:
+  /**
+   * Compile and attach the stages one by one, keeping the shaders alive
+   * until the program is linked
+   */
+  void LinkStages(const ShaderSource *first, const ShaderSource *last) {
+    if (first == last) {
+      Link();
+      return;
+    }
+    details::VisitStage(first->stage, [&](auto stage) {
+      Shader<decltype(stage)::value> shader{first->source};
+      Attach(shader);
+      LinkStages(first + 1, last);
+      Detach(shader);
+    });
+  }
+
+  struct ShadowSlot {
+    std::size_t offset, size;
+    std::size_t known;  // Leading bytes holding the last value
+  };
+
+  void Reflect() {
+    uniform_locs_ =
+        GetLocations<GL_ACTIVE_UNIFORMS, GL_ACTIVE_UNIFORM_MAX_LENGTH>(
+            glGetActiveUniform, glGetUniformLocation);
+    attrib_locs_ =
+        GetLocations<GL_ACTIVE_ATTRIBUTES, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH>(
+            glGetActiveAttrib, glGetAttribLocation);
+    uniform_blocks_ = GetBlocks(GL_UNIFORM_BLOCK, GL_UNIFORM);
+    storage_blocks_ = GetBlocks(GL_SHADER_STORAGE_BLOCK, GL_BUFFER_VARIABLE);
+    outputs_ = GetOutputs();
+    work_group_size_ = {0, 0, 0};
+    if (compute_) {
+      glGetProgramiv(Id(), GL_COMPUTE_WORK_GROUP_SIZE,
+                     work_group_size_.data());
+    }
+    AllocateShadow();
+  }
+
+  GLint GetInterfaceParam(GLenum interface, GLenum pname) {
+    GLint ret;
+    glGetProgramInterfaceiv(Id(), interface, pname, &ret);
+    return ret;
+  }
+
+  /**
+   * Whether a compute shader is attached, checked before linking since a
+   * linked program cannot tell
+   */
+  bool HasComputeStage() {
+    const auto count = GetParam(GL_ATTACHED_SHADERS);
+    std::vector<GLuint> shaders(count);
+    if (count > 0) {
+      glGetAttachedShaders(Id(), count, nullptr, shaders.data());
+    }
+    for (const auto shader : shaders) {
+      GLint type;
+      glGetShaderiv(shader, GL_SHADER_TYPE, &type);
+      if (type == GL_COMPUTE_SHADER) return true;
+    }
+    return false;
+  }
+
+  Variables GetOutputs() {
+    Variables outputs;
+    const auto count =
+        GetInterfaceParam(GL_PROGRAM_OUTPUT, GL_ACTIVE_RESOURCES);
+    for (GLuint i = 0; i < GLuint(count); i++) {
+      outputs[GetResourceName(GL_PROGRAM_OUTPUT, i)] = {
+          GetResourceParam(GL_PROGRAM_OUTPUT, i, GL_LOCATION),
+          GLenum(GetResourceParam(GL_PROGRAM_OUTPUT, i, GL_TYPE)),
+          GetResourceParam(GL_PROGRAM_OUTPUT, i, GL_ARRAY_SIZE)};
+    }
+    return outputs;
+  }
+
+  void AllocateShadow() {
+    shadow_slots_.clear();
+    shadow_.clear();
+    if (!shadowed_) return;
+    for (const auto &[name, var] : uniform_locs_) {
+      if (var.location < 0) continue;
+      if (GLint(shadow_slots_.size()) <= var.location) {
+        shadow_slots_.resize(var.location + 1, {0, 0, 0});
+      }
+      auto &slot = shadow_slots_[var.location];
+      if (slot.size > 0) continue;  // Array also found without [0]
+      slot.offset = shadow_.size();
+      slot.size = details::UniformTypeSize(var.type) * var.size;
+      shadow_.resize(slot.offset + slot.size);
+    }
+  }
+
+  /**
+   * Store the value and return whether it changed. Values of unknown size
+   * or set from inside an array are not shadowed.
+   */
+  bool UpdateShadow(GLint location, const void *data, std::size_t size) {
+    if (location < 0 || location >= GLint(shadow_slots_.size())) return true;
+    auto &slot = shadow_slots_[location];
+    if (size > slot.size) return true;
+    const auto shadow = shadow_.data() + slot.offset;
+    if (size <= slot.known && std::memcmp(shadow, data, size) == 0) {
+      return false;
+    }
+    std::memcpy(shadow, data, size);
+    slot.known = std::max(slot.known, size);
+    return true;
+  }
+
+  GLint GetResourceParam(GLenum interface, GLuint index, GLenum prop) {
+    GLint ret;
+    glGetProgramResourceiv(Id(), interface, index, 1, &prop, 1, nullptr, &ret);
+    return ret;
+  }
+
+  std::string GetResourceName(GLenum interface, GLuint index) {
+    std::string name(GetResourceParam(interface, index, GL_NAME_LENGTH), '\0');
+    GLsizei length = 0;
+    glGetProgramResourceName(Id(), interface, index, GLsizei(name.size()),
+                             &length, name.data());
+    name.resize(length);
+    return name;
+  }
+
+  /**
+   * Get the blocks of an interface and the offsets of their members
+   */
+  Blocks GetBlocks(GLenum interface, GLenum member_interface) {
+    Blocks blocks;
+    const auto count = GetInterfaceParam(interface, GL_ACTIVE_RESOURCES);
+    for (GLuint i = 0; i < GLuint(count); i++) {
+      auto &block = blocks[GetResourceName(interface, i)];
+      block.index = i;
+      block.binding = GetResourceParam(interface, i, GL_BUFFER_BINDING);
+      block.size = GetResourceParam(interface, i, GL_BUFFER_DATA_SIZE);
+
+      const auto member_count =
+          GetResourceParam(interface, i, GL_NUM_ACTIVE_VARIABLES);
+      std::vector<GLint> members(member_count);
+      const GLenum prop = GL_ACTIVE_VARIABLES;
+      glGetProgramResourceiv(Id(), interface, i, 1, &prop, member_count,
+                             nullptr, members.data());
+      for (const auto member : members) {
+        block.offsets[GetResourceName(member_interface, member)] =
+            GetResourceParam(member_interface, member, GL_OFFSET);
+      }
+    }
+    return blocks;
+  }
+
   /**
    * Get Uniform/Attribute location
    */
   template <GLenum GL_ACTIVE_X, GLenum GL_ACTIVE_X_MAX_LENGTH,
             typename glGetActiveX, typename glGetXLocation>
-  std::unordered_map<std::string, GLint> GetLocations(glGetActiveX f1,
-                                                      glGetXLocation f2) {
-    std::unordered_map<std::string, GLint> locs;
+  Variables GetLocations(glGetActiveX f1, glGetXLocation f2) {
+    Variables locs;
     const auto count = GetParam(GL_ACTIVE_X);
     const auto max_len = GetParam(GL_ACTIVE_X_MAX_LENGTH);
     for (GLint i = 0; i < count; i++) {
@@ -108,34 +579,149 @@ class Program : public details::Object<details::ProgramTrait> {
       GLenum type;
       f1(Id(), i, max_len, &length, &size, &type, name.data());
       name.resize(length);
-      locs[name] = f2(Id(), name.c_str());
+      const ProgramVariable var{f2(Id(), name.c_str()), type, size};
+      locs[name] = var;
+      // Arrays are also found without the [0] suffix.
+      const auto suffix = name.rfind("[0]");
+      if (suffix != std::string::npos && suffix + 3 == name.size()) {
+        locs[name.substr(0, suffix)] = var;
+      }
     }
     return locs;
   }
 
-  std::unordered_map<std::string, GLint> uniform_locs_, attrib_locs_;
+  Variables uniform_locs_, attrib_locs_, outputs_;
+  Blocks uniform_blocks_, storage_blocks_;
+  std::array<GLint, 3> work_group_size_{0, 0, 0};
+  bool compute_{false};
+  bool shadowed_{false};
+  std::vector<ShadowSlot> shadow_slots_;
+  std::vector<unsigned char> shadow_;
+  UniformUpdateStats uniform_stats_;
 };
 
-template <>
-inline void Program::Uniform<int>(const std::string &name, const int &val) {
-  glProgramUniform1i(Id(), uniform_locs_.at(name), val);
-}
+/**
+ * Uniform location resolved once, set without name lookup. Valid while the
+ * program is alive and not relinked.
+ */
+template <typename T>
+class UniformHandle {
+ public:
+  UniformHandle() = default;
 
-template <>
-inline void Program::Uniform<float>(const std::string &name, const float &val) {
-  glProgramUniform1f(Id(), uniform_locs_.at(name), val);
-}
+  UniformHandle(Program &program, GLint location)
+      : program_{&program}, location_{location} {}
 
-template <>
-inline void Program::Uniform<glm::vec3>(const std::string &name,
-                                        const glm::vec3 &val) {
-  glProgramUniform3fv(Id(), uniform_locs_.at(name), 1, glm::value_ptr(val));
-}
+  void Set(const T &val) { program_->Uniform(location_, val); }
+
+  void Set(const T *data, GLsizei count) {
+    program_->Uniform(location_, data, count);
+  }
+
+  [[nodiscard]] GLint Location() const { return location_; }
+
+ private:
+  Program *program_{nullptr};
+  GLint location_{-1};
+};
 
-template <>
-inline void Program::Uniform<glm::mat4>(const std::string &name,
-                                        const glm::mat4 &val) {
-  glProgramUniformMatrix4fv(Id(), uniform_locs_.at(name), 1, GL_FALSE,
-                            glm::value_ptr(val));
+template <typename T>
+UniformHandle<T> Program::GetUniform(const std::string &name) {
+  const auto &uniform = uniform_locs_.at(name);
+  if (!details::UniformTypeMatches<T>(uniform.type)) {
+    throw std::invalid_argument("Uniform type mismatch: " + name);
+  }
+  return {*this, uniform.location};
 }
+
+namespace details {
+#define UNIFORM_SETTER_DEFINE(T, gl_type, call)                    \
+  template <>                                                      \
+  struct UniformSetter<T> {                                        \
+    using element_type = T;                                        \
+    static constexpr GLenum type = gl_type;                        \
+                                                                   \
+    static void Set(GLuint program, GLint location, GLsizei count, \
+                    const T *val) {                                \
+      call;                                                        \
+    }                                                              \
+  };
+
+#define UNIFORM_VEC_DEFINE(T, gl_type, suffix) \
+  UNIFORM_SETTER_DEFINE(                       \
+      T, gl_type,                              \
+      glProgramUniform##suffix(program, location, count, glm::value_ptr(*val)))
+
+#define UNIFORM_MAT_DEFINE(T, gl_type, suffix)                             \
+  UNIFORM_SETTER_DEFINE(T, gl_type,                                        \
+                        glProgramUniformMatrix##suffix(program, location,  \
+                                                       count, GL_FALSE,    \
+                                                       glm::value_ptr(*val)))
+
+UNIFORM_SETTER_DEFINE(float, GL_FLOAT,
+                      glProgramUniform1fv(program, location, count, val))
+UNIFORM_VEC_DEFINE(glm::vec2, GL_FLOAT_VEC2, 2fv)
+UNIFORM_VEC_DEFINE(glm::vec3, GL_FLOAT_VEC3, 3fv)
+UNIFORM_VEC_DEFINE(glm::vec4, GL_FLOAT_VEC4, 4fv)
+
+UNIFORM_SETTER_DEFINE(int, GL_INT,
+                      glProgramUniform1iv(program, location, count, val))
+UNIFORM_VEC_DEFINE(glm::ivec2, GL_INT_VEC2, 2iv)
+UNIFORM_VEC_DEFINE(glm::ivec3, GL_INT_VEC3, 3iv)
+UNIFORM_VEC_DEFINE(glm::ivec4, GL_INT_VEC4, 4iv)
+
+UNIFORM_SETTER_DEFINE(glm::uint, GL_UNSIGNED_INT,
+                      glProgramUniform1uiv(program, location, count, val))
+UNIFORM_VEC_DEFINE(glm::uvec2, GL_UNSIGNED_INT_VEC2, 2uiv)
+UNIFORM_VEC_DEFINE(glm::uvec3, GL_UNSIGNED_INT_VEC3, 3uiv)
+UNIFORM_VEC_DEFINE(glm::uvec4, GL_UNSIGNED_INT_VEC4, 4uiv)
+
+UNIFORM_SETTER_DEFINE(double, GL_DOUBLE,
+                      glProgramUniform1dv(program, location, count, val))
+UNIFORM_VEC_DEFINE(glm::dvec2, GL_DOUBLE_VEC2, 2dv)
+UNIFORM_VEC_DEFINE(glm::dvec3, GL_DOUBLE_VEC3, 3dv)
+UNIFORM_VEC_DEFINE(glm::dvec4, GL_DOUBLE_VEC4, 4dv)
+
+UNIFORM_MAT_DEFINE(glm::mat2, GL_FLOAT_MAT2, 2fv)
+UNIFORM_MAT_DEFINE(glm::mat3, GL_FLOAT_MAT3, 3fv)
+UNIFORM_MAT_DEFINE(glm::mat4, GL_FLOAT_MAT4, 4fv)
+UNIFORM_MAT_DEFINE(glm::mat2x3, GL_FLOAT_MAT2x3, 2x3fv)
+UNIFORM_MAT_DEFINE(glm::mat2x4, GL_FLOAT_MAT2x4, 2x4fv)
+UNIFORM_MAT_DEFINE(glm::mat3x2, GL_FLOAT_MAT3x2, 3x2fv)
+UNIFORM_MAT_DEFINE(glm::mat3x4, GL_FLOAT_MAT3x4, 3x4fv)
+UNIFORM_MAT_DEFINE(glm::mat4x2, GL_FLOAT_MAT4x2, 4x2fv)
+UNIFORM_MAT_DEFINE(glm::mat4x3, GL_FLOAT_MAT4x3, 4x3fv)
+
+UNIFORM_MAT_DEFINE(glm::dmat2, GL_DOUBLE_MAT2, 2dv)
+UNIFORM_MAT_DEFINE(glm::dmat3, GL_DOUBLE_MAT3, 3dv)
+UNIFORM_MAT_DEFINE(glm::dmat4, GL_DOUBLE_MAT4, 4dv)
+UNIFORM_MAT_DEFINE(glm::dmat2x3, GL_DOUBLE_MAT2x3, 2x3dv)
+UNIFORM_MAT_DEFINE(glm::dmat2x4, GL_DOUBLE_MAT2x4, 2x4dv)
+UNIFORM_MAT_DEFINE(glm::dmat3x2, GL_DOUBLE_MAT3x2, 3x2dv)
+UNIFORM_MAT_DEFINE(glm::dmat3x4, GL_DOUBLE_MAT3x4, 3x4dv)
+UNIFORM_MAT_DEFINE(glm::dmat4x2, GL_DOUBLE_MAT4x2, 4x2dv)
+UNIFORM_MAT_DEFINE(glm::dmat4x3, GL_DOUBLE_MAT4x3, 4x3dv)
+
+#undef UNIFORM_MAT_DEFINE
+#undef UNIFORM_VEC_DEFINE
+#undef UNIFORM_SETTER_DEFINE
+
+/**
+ * Arrays are uploaded in one call, as uniform arrays of their element type
+ */
+template <typename T>
+struct UniformArraySetter {
+  using element_type = typename UniformSetter<T>::element_type;
+  static constexpr GLenum type = UniformSetter<T>::type;
+};
+
+template <typename T, std::size_t N>
+struct UniformSetter<T[N]> : UniformArraySetter<T> {};
+
+template <typename T, std::size_t N>
+struct UniformSetter<std::array<T, N>> : UniformArraySetter<T> {};
+
+template <typename T, typename Allocator>
+struct UniformSetter<std::vector<T, Allocator>> : UniformArraySetter<T> {};
+}  // namespace details
 }  // namespace glpp
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "details/hash.hpp"
+#include "gl.h"
+#include "program.hpp"
+#include "shader.hpp"
+
+namespace glpp {
+/**
+ * On-disk cache of linked program binaries, one file per program named
+ * after a hash of its stage sources and of the driver vendor, renderer and
+ * version. Binaries rejected by the driver are rebuilt from source.
+ */
+class ProgramCache {
+ public:
+  explicit ProgramCache(std::filesystem::path directory)
+      : directory_{std::move(directory)} {
+    std::filesystem::create_directories(directory_);
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    enabled_ = formats > 0;
+    driver_hash_ = details::Fnv1a(GetString(GL_VENDOR));
+    driver_hash_ = details::Fnv1a(GetString(GL_RENDERER), driver_hash_);
+    driver_hash_ = details::Fnv1a(GetString(GL_VERSION), driver_hash_);
+  }
+
+  /**
+   * Program linked from the sources, loaded from the cache when possible.
+   * Defines must already be part of the sources to be part of the key.
+   */
+  Program Load(const std::vector<ShaderSource> &sources) {
+    Program program;
+    const auto path = directory_ / (ToHex(Key(sources)) + ".bin");
+    const auto binary = enabled_ ? ReadFile(path) : ProgramBinary{0, {}};
+    if (!binary.data.empty() && program.LoadBinary(binary)) {
+      ++hits_;
+      return program;
+    }
+
+    ++misses_;
+    if (enabled_) program.Parameter(GL_PROGRAM_BINARY_RETRIEVABLE_HINT, 1);
+    program.Link(sources);
+    if (enabled_) WriteFile(path, program.GetBinary());
+    return program;
+  }
+
+  [[nodiscard]] std::size_t Hits() const { return hits_; }
+
+  [[nodiscard]] std::size_t Misses() const { return misses_; }
+
+ private:
+  static constexpr std::uint32_t kMagic = 0x32425047;  // "GPB2"
+
+  static std::string GetString(GLenum name) {
+    const auto str = reinterpret_cast<const char *>(glGetString(name));
+    return str ? str : "";
+  }
+
+  static std::string ToHex(std::uint64_t hash) {
+    char str[17];
+    std::snprintf(str, sizeof(str), "%016llx",
+                  static_cast<unsigned long long>(hash));
+    return str;
+  }
+
+  [[nodiscard]] std::uint64_t Key(
+      const std::vector<ShaderSource> &sources) const {
+    auto hash = driver_hash_;
+    for (const auto &source : sources) {
+      hash = details::Fnv1a(source.stage, hash);
+      hash = details::Fnv1a(source.source.size(), hash);
+      hash = details::Fnv1a(source.source, hash);
+    }
+    return hash;
+  }
+
+  static ProgramBinary ReadFile(const std::filesystem::path &path) {
+    ProgramBinary binary{0, {}};
+    std::ifstream stream(path, std::ios::binary);
+    std::uint32_t magic = 0;
+    stream.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    stream.read(reinterpret_cast<char *>(&binary.format),
+                sizeof(binary.format));
+    stream.read(reinterpret_cast<char *>(&binary.compute),
+                sizeof(binary.compute));
+    if (!stream || magic != kMagic) return binary;
+    binary.data.assign(std::istreambuf_iterator<char>(stream), {});
+    return binary;
+  }
+
+  /**
+   * Written to a temporary file first so that readers never see a partial
+   * binary
+   */
+  static void WriteFile(const std::filesystem::path &path,
+                        const ProgramBinary &binary) {
+    if (binary.data.empty()) return;
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+      std::ofstream stream(tmp, std::ios::binary | std::ios::trunc);
+      stream.write(reinterpret_cast<const char *>(&kMagic), sizeof(kMagic));
+      stream.write(reinterpret_cast<const char *>(&binary.format),
+                   sizeof(binary.format));
+      stream.write(reinterpret_cast<const char *>(&binary.compute),
+                   sizeof(binary.compute));
+      stream.write(binary.data.data(), std::streamsize(binary.data.size()));
+      if (!stream) return;
+    }
+    std::error_code error;
+    std::filesystem::rename(tmp, path, error);
+    if (error) std::filesystem::remove(tmp, error);
+  }
+
+  std::filesystem::path directory_;
+  bool enabled_;
+  std::uint64_t driver_hash_;
+  std::size_t hits_{0}, misses_{0};
+};
+}  // namespace glpp
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include "details/object.hpp"
+#include "gl.h"
+#include "name_pool.hpp"
+#include "program.hpp"
+#include "shader.hpp"
+
+namespace glpp {
+namespace details {
+struct ProgramPipelineTrait {
+  static GLuint Create() {
+    return NamePool<ProgramPipelineTrait>::Get().Acquire();
+  }
+
+  static void Create(GLsizei n, GLuint *ids) {
+    glCreateProgramPipelines(n, ids);
+  }
+
+  static void Delete(GLuint id) {
+    NamePool<ProgramPipelineTrait>::Get().Release(id);
+  }
+
+  static void Delete(GLsizei n, const GLuint *ids) {
+    glDeleteProgramPipelines(n, ids);
+  }
+
+  static void Bind(GLuint id) { glBindProgramPipeline(id); }
+};
+
+inline GLbitfield StageBit(ShaderStage stage) {
+  switch (stage) {
+    case ShaderStage::VERTEX_SHADER:
+      return GL_VERTEX_SHADER_BIT;
+    case ShaderStage::GEOMETRY_SHADER:
+      return GL_GEOMETRY_SHADER_BIT;
+    case ShaderStage::FRAGMENT_SHADER:
+      return GL_FRAGMENT_SHADER_BIT;
+    case ShaderStage::COMPUTE_SHADER:
+      return GL_COMPUTE_SHADER_BIT;
+  }
+  return 0;
+}
+}  // namespace details
+
+/**
+ * Combination of separable programs, one per stage, so that N vertex and M
+ * fragment variants need N + M links instead of N * M
+ */
+class ProgramPipeline : public details::Object<details::ProgramPipelineTrait> {
+ public:
+  using details::Object<details::ProgramPipelineTrait>::Object;
+
+  /**
+   * Use the separable program for the stages, given as GL_*_SHADER_BIT
+   */
+  void UseProgramStages(GLbitfield stages, const Program &program) {
+    glUseProgramStages(Id(), stages, program.Id());
+  }
+
+  template <typename... Stages>
+  void UseProgramStages(const Program &program, Stages... stages) {
+    UseProgramStages((details::StageBit(stages) | ...), program);
+  }
+
+  /**
+   * Bind for drawing; programs made current with Program::Use() take
+   * precedence, so it is reset
+   */
+  void Bind() {
+    glUseProgram(0);
+    details::Object<details::ProgramPipelineTrait>::Bind();
+  }
+
+  GLint GetParam(GLenum pname) {
+    GLint ret;
+    glGetProgramPipelineiv(Id(), pname, &ret);
+    return ret;
+  }
+
+  /**
+   * Check that the stages can execute with the current state, logging why
+   * not
+   */
+  bool Validate() {
+    glValidateProgramPipeline(Id());
+    const auto log_length = GetParam(GL_INFO_LOG_LENGTH);
+    if (log_length > 0) {
+      std::string msg(log_length, '\0');
+      glGetProgramPipelineInfoLog(Id(), log_length, nullptr, msg.data());
+      std::clog << "Program pipeline validation log: " << msg << std::endl;
+    }
+    return GetParam(GL_VALIDATE_STATUS) == GL_TRUE;
+  }
+};
+}  // namespace glpp
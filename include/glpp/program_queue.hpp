@@ -0,0 +1,107 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "extensions.hpp"
+#include "gl.h"
+#include "program.hpp"
+#include "shader.hpp"
+
+namespace glpp {
+/**
+ * Compiles and links programs in bulk without blocking. With
+ * KHR_parallel_shader_compile the driver builds them on its own threads and
+ * Poll() only finishes the completed ones; without it, Poll() finishes all.
+ */
+class ProgramQueue {
+ public:
+  using Callback = std::function<void(Program)>;
+
+  /**
+   * Limit the driver compiler threads, 0 to disable parallel compilation
+   */
+  static void SetCompilerThreads(GLuint count) {
+    const auto set = details::extensions.max_shader_compiler_threads;
+    if (set) set(count);
+  }
+
+  /**
+   * Start building a program; on_ready receives it, linked and reflected,
+   * from Poll() or Finish()
+   */
+  void Submit(const std::vector<ShaderSource> &sources, Callback on_ready) {
+    Job job{Program(), {}, std::move(on_ready)};
+    for (const auto &source : sources) {
+      details::VisitStage(source.stage, [&](auto stage) {
+        auto shader = std::make_shared<Shader<decltype(stage)::value>>();
+        shader->SetSource(source.source);
+        shader->CompileAsync();
+        job.program.Attach(*shader);
+        job.stages.push_back(
+            {shader->Id(), [shader] { shader->CheckCompile(); }});
+      });
+    }
+    job.program.LinkAsync();
+    jobs_.push_back(std::move(job));
+  }
+
+  /**
+   * Finish the completed programs and return their count. A build error is
+   * thrown after removing the failed program; the others stay queued.
+   */
+  std::size_t Poll() {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < jobs_.size();) {
+      if (!jobs_[i].program.IsLinkComplete()) {
+        ++i;
+        continue;
+      }
+      auto job = std::move(jobs_[i]);
+      jobs_.erase(jobs_.begin() + i);
+      Complete(job);
+      ++count;
+    }
+    return count;
+  }
+
+  /**
+   * Block until every submitted program is finished
+   */
+  void Finish() {
+    while (!jobs_.empty()) {
+      auto job = std::move(jobs_.front());
+      jobs_.erase(jobs_.begin());
+      Complete(job);
+    }
+  }
+
+  [[nodiscard]] std::size_t Pending() const { return jobs_.size(); }
+
+ private:
+  struct Stage {
+    GLuint id;
+    std::function<void()> check_compile;  // Owns the shader
+  };
+
+  struct Job {
+    Program program;
+    std::vector<Stage> stages;
+    Callback on_ready;
+  };
+
+  static void Complete(Job &job) {
+    if (job.program.GetParam(GL_LINK_STATUS) != GL_TRUE) {
+      // Report the compilation log first, it explains the link failure.
+      for (auto &stage : job.stages) stage.check_compile();
+    }
+    job.program.FinishLink();
+    for (auto &stage : job.stages) glDetachShader(job.program.Id(), stage.id);
+    job.on_ready(std::move(job.program));
+  }
+
+  std::vector<Job> jobs_;
+};
+}  // namespace glpp
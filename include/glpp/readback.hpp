@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "buffer.hpp"
+#include "gl.h"
+#include "sync.hpp"
+
+namespace glpp {
+/**
+ * Asynchronous buffer readback through a ring of persistently mapped staging
+ * slots in client memory. A request stays valid until its slot is reused,
+ * i.e. for the next `slots - 1` reads.
+ */
+class BufferReadback {
+ public:
+  struct Request {
+    GLsizei slot;
+    std::uint64_t serial;
+  };
+
+  explicit BufferReadback(GLsizeiptr capacity, GLsizei slots = 3,
+                          GLsizeiptr alignment = 256)
+      : capacity_{(capacity + alignment - 1) / alignment * alignment},
+        slots_(slots) {
+    constexpr GLbitfield flags =
+        GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const auto size = capacity_ * slots;
+    staging_.CreateStorage(size, nullptr, flags | GL_CLIENT_STORAGE_BIT);
+    data_ = static_cast<const unsigned char *>(
+        staging_.MapRange(0, size, flags));
+  }
+
+  /**
+   * Copy a range of src into the next slot. Data written to src by shaders
+   * needs glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT) beforehand.
+   */
+  Request Read(const Buffer &src, GLintptr offset, GLsizeiptr size) {
+    if (size > capacity_) {
+      throw std::length_error("Readback larger than slot capacity");
+    }
+    const auto index = GLsizei(next_);
+    auto &slot = slots_[index];
+    Buffer::CopySubData(src, staging_, offset, GLintptr(index) * capacity_,
+                        size);
+    slot.fence = Fence::Insert();
+    // So that polling IsReady() alone is enough for the fence to signal
+    glFlush();
+    slot.serial = ++serial_;
+    slot.size = size;
+    next_ = (next_ + 1) % slots_.size();
+    return {index, slot.serial};
+  }
+
+  /**
+   * Poll without blocking
+   */
+  bool IsReady(const Request &request) const {
+    return At(request).fence.IsSignaled();
+  }
+
+  /**
+   * Wait for the request if needed and return the mapped data
+   */
+  const void *Data(const Request &request) const {
+    At(request).fence.ClientWait();
+    return data_ + GLintptr(request.slot) * capacity_;
+  }
+
+  template <typename T>
+  const T *Data(const Request &request) const {
+    return static_cast<const T *>(Data(request));
+  }
+
+  [[nodiscard]] GLsizeiptr Size(const Request &request) const {
+    return At(request).size;
+  }
+
+ private:
+  struct Slot {
+    Fence fence;
+    std::uint64_t serial{0};
+    GLsizeiptr size{0};
+  };
+
+  const Slot &At(const Request &request) const {
+    const auto &slot = slots_.at(request.slot);
+    if (slot.serial != request.serial) {
+      throw std::runtime_error("Readback request expired");
+    }
+    return slot;
+  }
+
+  Buffer staging_;
+  GLsizeiptr capacity_;
+  std::vector<Slot> slots_;
+  std::size_t next_{0};
+  std::uint64_t serial_{0};
+  const unsigned char *data_{nullptr};
+};
+}  // namespace glpp
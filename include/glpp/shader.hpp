@@ -1,11 +1,14 @@
 #pragma once
 
-#include <fstream>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 
 #include "details/object.hpp"
+#include "extensions.hpp"
 #include "gl.h"
+#include "shader_loader.hpp"
 
 namespace glpp {
 enum class ShaderStage : GLenum {
@@ -42,8 +45,30 @@ class Shader : public details::Object<details::ShaderTrait<stage>> {
   }
 
   void Compile() {
-    glCompileShader(Id());
+    CompileAsync();
+    CheckCompile();
+  }
+
+  /**
+   * Start compiling without waiting for the result
+   */
+  void CompileAsync() { glCompileShader(Id()); }
+
+  /**
+   * Whether the result is available without blocking. Always true without
+   * KHR_parallel_shader_compile.
+   */
+  [[nodiscard]] bool IsCompileComplete() const {
+    if (!details::extensions.parallel_shader_compile) return true;
+    GLint done = GL_TRUE;
+    glGetShaderiv(Id(), GL_COMPLETION_STATUS_KHR, &done);
+    return done == GL_TRUE;
+  }
 
+  /**
+   * Wait for the compilation, log and throw on error
+   */
+  void CheckCompile() {
     // Check Shader.
     auto result = GL_FALSE;
     glGetShaderiv(Id(), GL_COMPILE_STATUS, &result);
@@ -61,16 +86,15 @@ class Shader : public details::Object<details::ShaderTrait<stage>> {
   }
 
   static Shader FromFile(const std::string &file_path) {
-    std::string source;
-    std::ifstream stream(file_path, std::ios::in);
-    if (stream.is_open()) {
-      std::string line;
-      while (getline(stream, line)) source += "\n" + line;
-      stream.close();
-    } else {
-      throw std::runtime_error("Cannot open " + file_path);
-    }
-    return Shader(source);
+    return FromFile(file_path, ShaderLoader::Default());
+  }
+
+  /**
+   * Read with the loader, which expands #include directives and caches the
+   * files it read
+   */
+  static Shader FromFile(const std::string &file_path, ShaderLoader &loader) {
+    return Shader(loader.Load(file_path));
   }
 };
 
@@ -78,4 +102,35 @@ using VertexShader = Shader<ShaderStage::VERTEX_SHADER>;
 using GeometryShader = Shader<ShaderStage::GEOMETRY_SHADER>;
 using FragmentShader = Shader<ShaderStage::FRAGMENT_SHADER>;
 using ComputeShader = Shader<ShaderStage::COMPUTE_SHADER>;
+
+/**
+ * Source of a stage chosen at run time
+ */
+struct ShaderSource {
+  ShaderStage stage;
+  std::string source;
+};
+
+namespace details {
+template <ShaderStage stage>
+using StageTag = std::integral_constant<ShaderStage, stage>;
+
+/**
+ * Call f with the StageTag of a stage known at run time
+ */
+template <typename F>
+void VisitStage(ShaderStage stage, F &&f) {
+  switch (stage) {
+    case ShaderStage::VERTEX_SHADER:
+      return f(StageTag<ShaderStage::VERTEX_SHADER>{});
+    case ShaderStage::GEOMETRY_SHADER:
+      return f(StageTag<ShaderStage::GEOMETRY_SHADER>{});
+    case ShaderStage::FRAGMENT_SHADER:
+      return f(StageTag<ShaderStage::FRAGMENT_SHADER>{});
+    case ShaderStage::COMPUTE_SHADER:
+      return f(StageTag<ShaderStage::COMPUTE_SHADER>{});
+  }
+  throw std::invalid_argument("Unknown shader stage");
+}
+}  // namespace details
 }  // namespace glpp
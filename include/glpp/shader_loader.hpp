@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "details/hash.hpp"
+
+namespace glpp {
+/**
+ * Reads shader files and expands their #include "file" directives, searched
+ * next to the including file then in the include directories. Directives in
+ * block comments and #if 0 regions are left alone. Files are cached until
+ * their modification time changes, and the include graph is kept so that
+ * the shaders affected by a change can be found. Thread safe.
+ */
+class ShaderLoader {
+ public:
+  using Path = std::filesystem::path;
+
+  explicit ShaderLoader(std::vector<Path> include_dirs = {})
+      : include_dirs_{std::move(include_dirs)} {}
+
+  /**
+   * Loader shared by Shader::FromFile
+   */
+  static ShaderLoader &Default() {
+    static ShaderLoader loader;
+    return loader;
+  }
+
+  void AddIncludeDir(const Path &dir) {
+    std::lock_guard lock(mutex_);
+    include_dirs_.push_back(dir);
+  }
+
+  /**
+   * Source of the file with its includes expanded. Unlike the C
+   * preprocessor, each file is included at most once per shader, as if it
+   * had include guards. #line directives map errors back to the files: the
+   * source string number is the position of the file in Dependencies().
+   */
+  std::string Load(const Path &path) {
+    std::lock_guard lock(mutex_);
+    const auto file = Canonical(path);
+    roots_.insert(file);
+    std::string source;
+    std::vector<Path> stack, included;
+    Expand(file, source, stack, included);
+    return source;
+  }
+
+  /**
+   * Hash of the expanded source, from the cached file hashes
+   */
+  std::uint64_t Hash(const Path &path) {
+    std::lock_guard lock(mutex_);
+    auto hash = details::kFnvOffsetBasis;
+    for (const auto &file : Closure(Canonical(path))) {
+      hash = details::Fnv1a(Read(file).hash, hash);
+    }
+    return hash;
+  }
+
+  /**
+   * The file and every file it includes, directly or not, in expansion order
+   */
+  std::vector<Path> Dependencies(const Path &path) {
+    std::lock_guard lock(mutex_);
+    return Closure(Canonical(path));
+  }
+
+  /**
+   * Files loaded with Load() that include the file, directly or not, itself
+   * included if it was loaded
+   */
+  std::vector<Path> Dependents(const Path &path) {
+    std::lock_guard lock(mutex_);
+    const auto file = Canonical(path);
+    std::vector<Path> dependents;
+    for (const auto &root : roots_) {
+      const auto closure = Closure(root);
+      if (std::find(closure.begin(), closure.end(), file) != closure.end()) {
+        dependents.push_back(root);
+      }
+    }
+    return dependents;
+  }
+
+  /**
+   * Drop the cached file so that it is read again
+   */
+  void Invalidate(const Path &path) {
+    std::lock_guard lock(mutex_);
+    files_.erase(Canonical(path));
+  }
+
+ private:
+  struct File {
+    std::filesystem::file_time_type mtime;
+    std::uint64_t hash;
+    std::vector<std::string> chunks;  // Text around the includes
+    std::vector<Path> includes;
+    std::vector<std::size_t> resume_lines;  // Line after each include
+  };
+
+  static Path Canonical(const Path &path) {
+    return std::filesystem::weakly_canonical(path);
+  }
+
+  /**
+   * Cached file, read again if modified
+   */
+  const File &Read(const Path &path) {
+    std::error_code error;
+    const auto mtime = std::filesystem::last_write_time(path, error);
+    if (error) throw std::runtime_error("Cannot open " + path.string());
+    const auto cached = files_.find(path);
+    if (cached != files_.end() && cached->second.mtime == mtime) {
+      return cached->second;
+    }
+
+    std::ifstream stream(path, std::ios::in | std::ios::binary);
+    if (!stream.is_open()) {
+      throw std::runtime_error("Cannot open " + path.string());
+    }
+    std::string content;
+    stream.seekg(0, std::ios::end);
+    content.resize(std::size_t(stream.tellg()));
+    stream.seekg(0, std::ios::beg);
+    stream.read(content.data(), std::streamsize(content.size()));
+
+    auto &file = files_[path];
+    file = Parse(path, content);
+    file.mtime = mtime;
+    file.hash = details::Fnv1a(content);
+    return file;
+  }
+
+  File Parse(const Path &path, const std::string &content) {
+    File file{};
+    std::size_t chunk_start = 0, number = 1;
+    bool in_comment = false;
+    int disabled = 0;  // Depth of nested conditionals inside #if 0
+    for (std::size_t line = 0; line < content.size(); ++number) {
+      auto end = content.find('\n', line);
+      end = end == std::string::npos ? content.size() : end + 1;
+      const auto hash = content.find_first_not_of(" \t", line);
+      if (!in_comment && hash < end && content[hash] == '#') {
+        const auto name =
+            std::min(content.find_first_not_of(" \t", hash + 1), end);
+        const auto arg = std::min(
+            content.find_first_not_of("abcdefghijklmnopqrstuvwxyz", name),
+            end);
+        const auto directive = content.substr(name, arg - name);
+        if (disabled > 0) {
+          if (directive == "if" || directive == "ifdef" ||
+              directive == "ifndef") {
+            ++disabled;
+          } else if (directive == "endif" ||
+                     (disabled == 1 &&
+                      (directive == "else" || directive == "elif"))) {
+            --disabled;
+          }
+        } else if (directive == "if" && IsZero(content, arg, end)) {
+          disabled = 1;
+        } else if (directive == "include") {
+          const auto open = content.find_first_of("\"<", arg);
+          const auto close =
+              open < end ? content.find_first_of("\">", open + 1) : end;
+          if (close >= end) {
+            throw std::runtime_error("Malformed #include in " + path.string());
+          }
+          file.chunks.push_back(
+              content.substr(chunk_start, line - chunk_start));
+          file.includes.push_back(
+              Resolve(path, content.substr(open + 1, close - open - 1)));
+          file.resume_lines.push_back(number + 1);
+          chunk_start = end;
+        }
+      }
+      in_comment = InComment(content, line, end, in_comment);
+      line = end;
+    }
+    file.chunks.push_back(content.substr(chunk_start));
+    return file;
+  }
+
+  /**
+   * Whether the argument of a directive starting at pos is the literal 0
+   */
+  static bool IsZero(const std::string &content, std::size_t pos,
+                     std::size_t end) {
+    pos = content.find_first_not_of(" \t", pos);
+    return pos < end && content[pos] == '0' &&
+           (pos + 1 == end || !std::isalnum(content[pos + 1]));
+  }
+
+  /**
+   * Whether a block comment is still open at the end of the line
+   */
+  static bool InComment(const std::string &content, std::size_t pos,
+                        std::size_t end, bool open) {
+    for (; pos + 1 < end; ++pos) {
+      if (open && content.compare(pos, 2, "*/") == 0) {
+        open = false;
+        ++pos;
+      } else if (!open && content.compare(pos, 2, "//") == 0) {
+        break;
+      } else if (!open && content.compare(pos, 2, "/*") == 0) {
+        open = true;
+        ++pos;
+      }
+    }
+    return open;
+  }
+
+  Path Resolve(const Path &from, const Path &name) {
+    auto candidate = from.parent_path() / name;
+    for (std::size_t i = 0; !std::filesystem::exists(candidate); ++i) {
+      if (i == include_dirs_.size()) {
+        throw std::runtime_error("Cannot find " + name.string() +
+                                 " included from " + from.string());
+      }
+      candidate = include_dirs_[i] / name;
+    }
+    return Canonical(candidate);
+  }
+
+  void Expand(const Path &path, std::string &source, std::vector<Path> &stack,
+              std::vector<Path> &included) {
+    if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+      throw std::runtime_error("Include cycle through " + path.string());
+    }
+    if (std::find(included.begin(), included.end(), path) != included.end()) {
+      return;
+    }
+    const auto index = std::to_string(included.size());
+    included.push_back(path);
+    stack.push_back(path);
+    const auto &file = Read(path);
+    // The root keeps its own numbering so that #version stays first.
+    if (index != "0") source += "#line 1 " + index + "\n";
+    for (std::size_t i = 0; i < file.includes.size(); ++i) {
+      source += file.chunks[i];
+      Expand(file.includes[i], source, stack, included);
+      if (!source.empty() && source.back() != '\n') source += '\n';
+      source += "#line " + std::to_string(file.resume_lines[i]) + " " +
+                index + "\n";
+    }
+    source += file.chunks.back();
+    stack.pop_back();
+  }
+
+  /**
+   * The file and every file it includes, in expansion order
+   */
+  std::vector<Path> Closure(const Path &path) {
+    std::vector<Path> closure, pending{path};
+    while (!pending.empty()) {
+      const auto file = pending.back();
+      pending.pop_back();
+      if (std::find(closure.begin(), closure.end(), file) != closure.end()) {
+        continue;
+      }
+      closure.push_back(file);
+      const auto &includes = Read(file).includes;
+      pending.insert(pending.end(), includes.rbegin(), includes.rend());
+    }
+    return closure;
+  }
+
+  std::mutex mutex_;
+  std::vector<Path> include_dirs_;
+  std::map<Path, File> files_;
+  std::set<Path> roots_;
+};
+}  // namespace glpp
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "background_uploader.hpp"
+#include "program.hpp"
+#include "shader.hpp"
+#include "shader_loader.hpp"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace glpp {
+/**
+ * Rebuilds programs when their shader files or includes change. Changes are
+ * detected with inotify on Linux and by polling modification times
+ * elsewhere. Programs are compiled and linked by the uploader on its shared
+ * context and replace the watched program in Update() only if they link, so
+ * the previous one keeps rendering meanwhile.
+ *
+ * A reloaded program is a new program object: uniform values, UniformHandles,
+ * block bindings and shadowing must be set again in the on_reload callback.
+ */
+class ShaderReloader {
+ public:
+  using Path = std::filesystem::path;
+  using Callback = std::function<void(Program &)>;
+
+  struct Stage {
+    ShaderStage stage;
+    Path path;
+  };
+
+  explicit ShaderReloader(BackgroundUploader &uploader,
+                          ShaderLoader &loader = ShaderLoader::Default())
+      : uploader_{uploader}, loader_{loader} {
+#ifdef __linux__
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd_ < 0) throw std::runtime_error("Cannot initialize inotify");
+#endif
+  }
+
+  ShaderReloader(const ShaderReloader &) = delete;
+
+  ShaderReloader &operator=(const ShaderReloader &) = delete;
+
+  ~ShaderReloader() {
+#ifdef __linux__
+    close(fd_);
+#endif
+  }
+
+  /**
+   * Build the program now and keep it up to date with its files. The
+   * reference stays valid for the lifetime of the reloader.
+   */
+  Program &Watch(std::vector<Stage> stages, Callback on_reload = {}) {
+    for (auto &stage : stages) {
+      stage.path = std::filesystem::weakly_canonical(stage.path);
+    }
+    auto entry = std::make_unique<Entry>();
+    entry->program.Link(Load(loader_, stages));
+    entry->stages = std::move(stages);
+    entry->on_reload = std::move(on_reload);
+    WatchFiles(*entry);
+    entries_.push_back(std::move(entry));
+    return entries_.back()->program;
+  }
+
+  /**
+   * Call on the render thread, e.g. once per frame. Starts rebuilding the
+   * programs whose files changed and swaps in those that finished linking.
+   * Returns the number of programs replaced.
+   */
+  std::size_t Update() {
+    for (const auto &path : PollChanges()) {
+      try {
+        loader_.Invalidate(path);
+        for (const auto &root : loader_.Dependents(path)) MarkDirty(root);
+      } catch (const std::exception &e) {
+        std::clog << "Shader reload failed: " << e.what() << std::endl;
+      }
+    }
+
+    std::size_t swapped = 0;
+    for (auto &entry : entries_) {
+      if (entry->pending && entry->pending->IsReady()) {
+        try {
+          entry->program = entry->pending->Get();
+          ++swapped;
+          if (entry->on_reload) entry->on_reload(entry->program);
+          WatchFiles(*entry);
+        } catch (const std::exception &e) {
+          std::clog << "Shader reload failed: " << e.what() << std::endl;
+        }
+        entry->pending.reset();
+      }
+      if (entry->dirty && !entry->pending) {
+        entry->dirty = false;
+        auto &loader = loader_;
+        entry->pending = uploader_.Submit([&loader, stages = entry->stages] {
+          Program program;
+          program.Link(Load(loader, stages));
+          return program;
+        });
+      }
+    }
+    return swapped;
+  }
+
+ private:
+  struct Entry {
+    Program program;
+    std::vector<Stage> stages;
+    Callback on_reload;
+    std::optional<Upload<Program>> pending;
+    bool dirty{false};
+  };
+
+  static std::vector<ShaderSource> Load(ShaderLoader &loader,
+                                        const std::vector<Stage> &stages) {
+    std::vector<ShaderSource> sources;
+    for (const auto &stage : stages) {
+      sources.push_back({stage.stage, loader.Load(stage.path)});
+    }
+    return sources;
+  }
+
+  void MarkDirty(const Path &root) {
+    for (auto &entry : entries_) {
+      for (const auto &stage : entry->stages) {
+        if (stage.path == root) entry->dirty = true;
+      }
+    }
+  }
+
+  /**
+   * Watch the stage files and their includes, which may have changed
+   */
+  void WatchFiles(const Entry &entry) {
+    for (const auto &stage : entry.stages) {
+      for (const auto &file : loader_.Dependencies(stage.path)) {
+#ifdef __linux__
+        // Directories are watched since editors often replace files.
+        const auto dir = file.parent_path();
+        if (!dirs_.insert(dir).second) continue;
+        const auto wd = inotify_add_watch(fd_, dir.c_str(),
+                                          IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd >= 0) watches_[wd] = dir;
+#else
+        mtimes_.emplace(file, std::filesystem::last_write_time(file));
+#endif
+      }
+    }
+  }
+
+  std::set<Path> PollChanges() {
+    std::set<Path> changed;
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(fd_, buffer, sizeof(buffer))) > 0) {
+      for (auto p = buffer; p < buffer + length;) {
+        const auto event = reinterpret_cast<const inotify_event *>(p);
+        p += sizeof(inotify_event) + event->len;
+        // Overflows and removed watches carry no known directory
+        const auto dir = watches_.find(event->wd);
+        if (dir == watches_.end()) continue;
+        if (event->mask & IN_IGNORED) {
+          // Watch again if the directory comes back
+          dirs_.erase(dir->second);
+          watches_.erase(dir);
+        } else if (event->len > 0) {
+          changed.insert(dir->second / event->name);
+        }
+      }
+    }
+#else
+    for (auto &[file, mtime] : mtimes_) {
+      std::error_code error;
+      const auto current = std::filesystem::last_write_time(file, error);
+      if (error || current == mtime) continue;
+      mtime = current;
+      changed.insert(file);
+    }
+#endif
+    return changed;
+  }
+
+  BackgroundUploader &uploader_;
+  ShaderLoader &loader_;
+  std::vector<std::unique_ptr<Entry>> entries_;
+#ifdef __linux__
+  int fd_;
+  std::set<Path> dirs_;
+  std::map<int, Path> watches_;
+#else
+  std::map<Path, std::filesystem::file_time_type> mtimes_;
+#endif
+};
+}  // namespace glpp
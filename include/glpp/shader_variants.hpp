@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "details/hash.hpp"
+#include "gl.h"
+#include "program.hpp"
+#include "shader.hpp"
+
+namespace glpp {
+/**
+ * Macro names and values, e.g. {{"PARTICLE_COUNT", "1024"}, {"FOG", ""}}
+ */
+using Defines = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * Source with the defines inserted after its #version line, or first if it
+ * has none. A #line directive follows them so that compiler errors keep the
+ * line numbers of the source.
+ */
+inline std::string InjectDefines(const std::string &source,
+                                 const Defines &defines) {
+  std::size_t pos = 0;
+  for (auto version = source.find("#version"); version != std::string::npos;
+       version = source.find("#version", version + 1)) {
+    const auto line = source.find_last_of('\n', version);
+    const auto start = line == std::string::npos ? 0 : line + 1;
+    if (source.find_first_not_of(" \t", start) != version) continue;
+    const auto end = source.find('\n', version);
+    pos = end == std::string::npos ? source.size() : end + 1;
+    break;
+  }
+
+  if (defines.empty()) return source;
+  std::string injected;
+  for (const auto &[name, value] : defines) {
+    injected += "#define " + name + " " + value + "\n";
+  }
+  auto result = source.substr(0, pos);
+  if (pos > 0 && result.back() != '\n') result += '\n';
+  const auto line = std::count(result.begin(), result.end(), '\n') + 1;
+  injected += "#line " + std::to_string(line) + "\n";
+  return result + injected + source.substr(pos);
+}
+
+/**
+ * Compiles each (source, defines) combination once and keeps the shaders and
+ * programs for reuse. Returned references stay valid until Clear().
+ */
+class ShaderVariants {
+ public:
+  /**
+   * Shader compiled from the source with the defines
+   */
+  template <ShaderStage stage>
+  const Shader<stage> &GetShader(const std::string &source,
+                                 const Defines &defines = {}) {
+    VariantKey key{{{stage, source}}, Sort(defines)};
+    auto &shader = shaders_[key];
+    if (!shader) {
+      shader = std::make_shared<Shader<stage>>(
+          InjectDefines(source, key.defines));
+    }
+    // The stage is part of the key, so the type is always right
+    return *std::static_pointer_cast<Shader<stage>>(shader);
+  }
+
+  /**
+   * Program linked from the stages, all compiled with the same defines
+   */
+  Program &GetProgram(const std::vector<ShaderSource> &sources,
+                      const Defines &defines = {}) {
+    VariantKey key{sources, Sort(defines)};
+    const auto found = programs_.find(key);
+    if (found != programs_.end()) return found->second;
+
+    Program program;
+    std::vector<GLuint> shaders;
+    for (const auto &source : sources) {
+      details::VisitStage(source.stage, [&](auto stage) {
+        const auto &shader =
+            GetShader<decltype(stage)::value>(source.source, key.defines);
+        program.Attach(shader);
+        shaders.push_back(shader.Id());
+      });
+    }
+    program.Link();
+    for (const auto shader : shaders) glDetachShader(program.Id(), shader);
+    return programs_.emplace(std::move(key), std::move(program))
+        .first->second;
+  }
+
+  void Clear() {
+    shaders_.clear();
+    programs_.clear();
+  }
+
+ private:
+  /**
+   * Defines in name order, so that the order they are given in does not
+   * create new variants
+   */
+  static Defines Sort(Defines defines) {
+    std::sort(defines.begin(), defines.end());
+    return defines;
+  }
+
+  /**
+   * Stages and defines of a variant, compared in full on lookup
+   */
+  struct VariantKey {
+    std::vector<ShaderSource> sources;
+    Defines defines;
+
+    bool operator==(const VariantKey &other) const {
+      return defines == other.defines &&
+             std::equal(sources.begin(), sources.end(), other.sources.begin(),
+                        other.sources.end(), [](const auto &a, const auto &b) {
+                          return a.stage == b.stage && a.source == b.source;
+                        });
+    }
+  };
+
+  struct VariantHash {
+    std::size_t operator()(const VariantKey &key) const {
+      auto hash = details::kFnvOffsetBasis;
+      for (const auto &source : key.sources) {
+        hash = details::Fnv1a(source.stage, hash);
+        hash = details::Fnv1a(source.source.size(), hash);
+        hash = details::Fnv1a(source.source, hash);
+      }
+      for (const auto &[name, value] : key.defines) {
+        hash = details::Fnv1a(name.size(), hash);
+        hash = details::Fnv1a(name, hash);
+        hash = details::Fnv1a(value.size(), hash);
+        hash = details::Fnv1a(value, hash);
+      }
+      return std::size_t(hash);
+    }
+  };
+
+  std::unordered_map<VariantKey, std::shared_ptr<void>, VariantHash> shaders_;
+  std::unordered_map<VariantKey, Program, VariantHash> programs_;
+};
+}  // namespace glpp
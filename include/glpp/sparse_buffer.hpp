@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "buffer.hpp"
+#include "extensions.hpp"
+#include "gl.h"
+
+namespace glpp {
+/**
+ * Virtually allocated buffer whose pages are committed on demand. Without
+ * GL_ARB_sparse_buffer, it is emulated by separate buffers of chunk_size
+ * bytes, created on commit; ranges are then only contiguous within a chunk.
+ */
+class SparseBuffer {
+ public:
+  explicit SparseBuffer(GLsizeiptr size,
+                        GLbitfield flags = GL_DYNAMIC_STORAGE_BIT,
+                        GLsizeiptr chunk_size = GLsizeiptr(64) << 20)
+      : sparse_{IsSupported()}, flags_{flags} {
+    page_size_ = sparse_ ? Buffer::SparsePageSize() : chunk_size;
+    size_ = (size + page_size_ - 1) / page_size_ * page_size_;
+    const auto pages = std::size_t(size_ / page_size_);
+    if (sparse_) {
+      buffer_.CreateStorage(size_, nullptr, flags | GL_SPARSE_STORAGE_BIT_ARB);
+      committed_.resize(pages);
+    } else {
+      chunks_.resize(pages);
+    }
+  }
+
+  /**
+   * Whether the sparse buffer extension is loaded, see LoadExtensions()
+   */
+  static bool IsSupported() {
+    return details::extensions.named_buffer_page_commitment != nullptr;
+  }
+
+  [[nodiscard]] bool IsSparse() const { return sparse_; }
+
+  [[nodiscard]] GLsizeiptr Size() const { return size_; }
+
+  [[nodiscard]] GLsizeiptr PageSize() const { return page_size_; }
+
+  /**
+   * Commit every page overlapping the range
+   */
+  void Commit(GLintptr offset, GLsizeiptr size) {
+    const auto first = std::size_t(offset / page_size_);
+    const auto last =
+        std::size_t((offset + size + page_size_ - 1) / page_size_);
+    SetCommitment(first, last, true);
+  }
+
+  /**
+   * Decommit every page entirely inside the range
+   */
+  void Decommit(GLintptr offset, GLsizeiptr size) {
+    const auto first = std::size_t((offset + page_size_ - 1) / page_size_);
+    const auto last = std::size_t((offset + size) / page_size_);
+    if (first < last) SetCommitment(first, last, false);
+  }
+
+  [[nodiscard]] bool IsCommitted(GLintptr offset) const {
+    const auto page = std::size_t(offset / page_size_);
+    return sparse_ ? bool(committed_.at(page)) : bool(chunks_.at(page));
+  }
+
+  /**
+   * Buffer, offset and contiguous size backing the byte at offset
+   */
+  [[nodiscard]] BufferRange Resolve(GLintptr offset) {
+    if (sparse_) return {&buffer_, offset, size_ - offset};
+    const auto page = std::size_t(offset / page_size_);
+    auto &chunk = chunks_.at(page);
+    if (!chunk) throw std::out_of_range("Sparse buffer page not committed");
+    const auto local = offset - GLintptr(page) * page_size_;
+    return {chunk.get(), local, page_size_ - local};
+  }
+
+  void SetSubData(GLsizeiptr size, const void *data, GLintptr offset) {
+    auto bytes = static_cast<const unsigned char *>(data);
+    while (size > 0) {
+      const auto range = Resolve(offset);
+      const auto n = std::min(size, range.size);
+      range.buffer->SetSubData(n, bytes, range.offset);
+      bytes += n;
+      offset += n;
+      size -= n;
+    }
+  }
+
+  /**
+   * The single backing buffer, only in sparse mode
+   */
+  [[nodiscard]] Buffer &GetBuffer() {
+    if (!sparse_) throw std::logic_error("Sparse buffer is emulated");
+    return buffer_;
+  }
+
+ private:
+  void SetCommitment(std::size_t first, std::size_t last, bool commit) {
+    if (sparse_) {
+      last = std::min(last, committed_.size());
+      for (auto i = first; i < last; ++i) committed_[i] = commit;
+      buffer_.PageCommitment(GLintptr(first) * page_size_,
+                             GLsizeiptr(last - first) * page_size_, commit);
+      return;
+    }
+    last = std::min(last, chunks_.size());
+    for (auto i = first; i < last; ++i) {
+      if (!commit) {
+        chunks_[i].reset();
+      } else if (!chunks_[i]) {
+        chunks_[i] = std::make_unique<Buffer>();
+        chunks_[i]->CreateStorage(page_size_, nullptr, flags_);
+      }
+    }
+  }
+
+  bool sparse_;
+  GLbitfield flags_;
+  GLsizeiptr page_size_, size_;
+  Buffer buffer_;
+  std::vector<char> committed_;
+  std::vector<std::unique_ptr<Buffer>> chunks_;
+};
+}  // namespace glpp
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+#include "buffer.hpp"
+#include "gl.h"
+#include "sync.hpp"
+
+namespace glpp {
+/**
+ * Persistently mapped ring of regions, each guarded by a fence.
+ * Acquire() a region, write it, issue the commands reading it, then Release().
+ */
+class StreamingBuffer {
+ public:
+  struct Region {
+    void *data;
+    GLintptr offset;
+    GLsizeiptr size;
+  };
+
+  explicit StreamingBuffer(GLsizeiptr region_size, GLsizei regions = 3,
+                           GLsizeiptr alignment = 256)
+      : region_size_{(region_size + alignment - 1) / alignment * alignment},
+        fences_(regions) {
+    constexpr GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const auto size = region_size_ * regions;
+    buffer_.CreateStorage(size, nullptr, flags);
+    data_ = static_cast<unsigned char *>(buffer_.MapRange(0, size, flags));
+  }
+
+  /**
+   * Wait until the GPU is done with the next region and return it
+   */
+  Region Acquire() {
+    auto &fence = fences_[current_];
+    fence.ClientWait();
+    fence = Fence();
+    const auto offset = GLintptr(current_) * region_size_;
+    return {data_ + offset, offset, region_size_};
+  }
+
+  /**
+   * Fence the acquired region after the commands reading it are issued
+   */
+  void Release() {
+    fences_[current_] = Fence::Insert();
+    current_ = (current_ + 1) % fences_.size();
+  }
+
+  [[nodiscard]] Buffer &GetBuffer() { return buffer_; }
+
+  [[nodiscard]] const Buffer &GetBuffer() const { return buffer_; }
+
+  [[nodiscard]] GLsizeiptr RegionSize() const { return region_size_; }
+
+  [[nodiscard]] GLsizei RegionCount() const { return GLsizei(fences_.size()); }
+
+ private:
+  Buffer buffer_;
+  GLsizeiptr region_size_;
+  std::vector<Fence> fences_;
+  std::size_t current_{0};
+  unsigned char *data_{nullptr};
+};
+}  // namespace glpp
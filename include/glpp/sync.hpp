@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdexcept>
+#include <utility>
+
+#include "deletion_queue.hpp"
+#include "gl.h"
+
+namespace glpp {
+class Fence {
+ public:
+  Fence() = default;
+
+  Fence(const Fence &) = delete;
+
+  Fence(Fence &&other) noexcept { std::swap(sync_, other.sync_); }
+
+  ~Fence() {
+    auto &queue = DeletionQueue::Get();
+    if (sync_ != nullptr && queue.IsDeferred()) {
+      queue.Push([](GLsync sync) { glDeleteSync(sync); }, sync_);
+    } else {
+      glDeleteSync(sync_);
+    }
+  }
+
+  Fence &operator=(const Fence &) = delete;
+
+  Fence &operator=(Fence &&other) noexcept {
+    if (this == &other) return *this;
+    Fence tmp(std::move(*this));
+    std::swap(sync_, other.sync_);
+    return *this;
+  }
+
+  static Fence Insert() {
+    Fence fence;
+    fence.sync_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    return fence;
+  }
+
+  [[nodiscard]] GLsync Id() const { return sync_; }
+
+  [[nodiscard]] bool Empty() const { return sync_ == nullptr; }
+
+  /**
+   * Give up ownership of the sync object
+   */
+  GLsync Release() { return std::exchange(sync_, nullptr); }
+
+  bool IsSignaled() const {
+    if (Empty()) return true;
+    GLint status;
+    glGetSynciv(sync_, GL_SYNC_STATUS, 1, nullptr, &status);
+    return status == GL_SIGNALED;
+  }
+
+  /**
+   * Block the calling thread until the fence is signaled
+   */
+  void ClientWait(GLuint64 timeout = 1000000) const {
+    if (Empty()) return;
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (true) {
+      switch (glClientWaitSync(sync_, flags, timeout)) {
+        case GL_ALREADY_SIGNALED:
+        case GL_CONDITION_SATISFIED:
+          return;
+        case GL_WAIT_FAILED:
+          throw std::runtime_error("Fence wait failed");
+        default:
+          flags = 0;
+      }
+    }
+  }
+
+  /**
+   * Make the server wait on the fence, e.g. for a fence from a shared context
+   */
+  void ServerWait() const {
+    if (!Empty()) glWaitSync(sync_, 0, GL_TIMEOUT_IGNORED);
+  }
+
+ private:
+  GLsync sync_{nullptr};
+};
+}  // namespace glpp
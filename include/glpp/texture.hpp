@@ -6,6 +6,7 @@
 
 #include "details/object.hpp"
 #include "gl.h"
+#include "name_pool.hpp"
 
 namespace glpp {
 enum class TextureType : GLenum {
@@ -18,13 +19,15 @@ enum class TextureType : GLenum {
 namespace details {
 template <TextureType type>
 struct TextureTrait {
-  static GLuint Create() {
-    GLuint id;
-    glCreateTextures(static_cast<GLenum>(type), 1, &id);
-    return id;
+  static GLuint Create() { return NamePool<TextureTrait>::Get().Acquire(); }
+
+  static void Create(GLsizei n, GLuint *ids) {
+    glCreateTextures(static_cast<GLenum>(type), n, ids);
   }
 
-  static void Delete(GLuint id) { glDeleteTextures(1, &id); }
+  static void Delete(GLuint id) { NamePool<TextureTrait>::Get().Release(id); }
+
+  static void Delete(GLsizei n, const GLuint *ids) { glDeleteTextures(n, ids); }
 
   using Target = TextureType;
 
@@ -72,6 +75,8 @@ class Texture1D
       public details::TextureFilteringMixin<Texture1D>,
       public details::TextureWrapMixin<Texture1D, GL_TEXTURE_WRAP_S> {
  public:
+  using details::Object<details::TextureTrait<TextureType::TEXTURE_1D>>::Object;
+
   void CreateStorage(GLsizei levels, GLenum internalformat, GLsizei width) {
     glTextureStorage1D(Id(), levels, internalformat, width);
   }
@@ -90,6 +95,8 @@ class Texture2D
       public details::TextureWrapMixin<Texture2D, GL_TEXTURE_WRAP_S,
                                        GL_TEXTURE_WRAP_T> {
  public:
+  using details::Object<details::TextureTrait<TextureType::TEXTURE_2D>>::Object;
+
   void CreateStorage(GLsizei levels, GLenum internalformat, GLsizei width,
                      GLsizei height) {
     glTextureStorage2D(Id(), levels, internalformat, width, height);
@@ -110,6 +117,9 @@ class TextureCubemap
       public details::TextureMipmapMixin<TextureCubemap>,
       public details::TextureFilteringMixin<TextureCubemap> {
  public:
+  using details::Object<
+      details::TextureTrait<TextureType::TEXTURE_CUBE_MAP>>::Object;
+
   void CreateStorage(GLsizei levels, GLenum internalformat, GLsizei size) {
     glTextureStorage2D(Id(), levels, internalformat, size, size);
   }
@@ -129,6 +139,9 @@ class TextureCubemapArray
       public details::TextureMipmapMixin<TextureCubemapArray>,
       public details::TextureFilteringMixin<TextureCubemapArray> {
  public:
+  using details::Object<
+      details::TextureTrait<TextureType::TEXTURE_CUBE_MAP_ARRAY>>::Object;
+
   void CreateStorage(GLsizei levels, GLenum internalformat, GLsizei size,
                      GLsizei layers) {
     glTextureStorage3D(Id(), levels, internalformat, size, size, layers * 6);
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "buffer.hpp"
+#include "gl.h"
+#include "layout.hpp"
+
+namespace glpp {
+/**
+ * Buffer holding an array of T, indexed by element instead of bytes.
+ * T is checked at compile time to be laid out as in GLSL.
+ */
+template <typename T, typename Layout = Std430>
+class TypedBuffer : public Buffer {
+  static_assert(details::IsLayoutCompatible<Layout, T>(),
+                "Type does not match the buffer layout");
+
+ public:
+  using value_type = T;
+
+  void CreateStorage(GLsizeiptr count, const T *data = nullptr,
+                     GLbitfield flags = 0) {
+    Buffer::CreateStorage(count * sizeof(T), data, flags);
+    size_ = count;
+  }
+
+  // For STL containers
+  template <typename Container,
+            typename = decltype(std::declval<const Container &>().data())>
+  void CreateStorage(const Container &arr, GLbitfield flags = 0) {
+    static_assert(std::is_same_v<typename Container::value_type, T>,
+                  "Container element type mismatch");
+    CreateStorage(arr.size(), arr.data(), flags);
+  }
+
+  void SetSubData(GLintptr first, GLsizeiptr count, const T *data) {
+    Buffer::SetSubData(count * sizeof(T), data, first * sizeof(T));
+  }
+
+  // For STL containers
+  template <typename Container,
+            typename = decltype(std::declval<const Container &>().data())>
+  void SetSubData(const Container &arr, GLintptr first = 0) {
+    static_assert(std::is_same_v<typename Container::value_type, T>,
+                  "Container element type mismatch");
+    SetSubData(first, arr.size(), arr.data());
+  }
+
+  T *MapRange(GLintptr first, GLsizeiptr count, GLbitfield access) {
+    return static_cast<T *>(
+        Buffer::MapRange(first * sizeof(T), count * sizeof(T), access));
+  }
+
+  void BindRange(BufferTarget target, GLuint index, GLintptr first,
+                 GLsizeiptr count) {
+    Buffer::BindRange(target, index, first * sizeof(T), count * sizeof(T));
+  }
+
+  [[nodiscard]] GLsizeiptr Size() const { return size_; }
+
+ private:
+  GLsizeiptr size_{0};
+};
+}  // namespace glpp
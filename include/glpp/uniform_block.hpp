@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "buffer.hpp"
+#include "gl.h"
+#include "layout.hpp"
+#include "program.hpp"
+#include "streaming_buffer.hpp"
+
+namespace glpp {
+/**
+ * C++ mirror of a std140 uniform block, uploaded once per frame and shared
+ * by every program attached to its binding point
+ */
+template <typename T>
+class UniformBlock {
+  static_assert(details::IsLayoutCompatible<Std140, T>(),
+                "Type does not match the std140 layout");
+
+ public:
+  explicit UniformBlock(GLuint binding, GLsizei regions = 3)
+      : binding_{binding}, stream_{sizeof(T), regions, OffsetAlignment()} {}
+
+  /**
+   * Source the named block of the program from this binding point
+   */
+  void Attach(Program &program, const std::string &block_name) {
+    if (program.GetUniformBlock(block_name).size > GLint(sizeof(T))) {
+      throw std::invalid_argument("Uniform block larger than its mirror: " +
+                                  block_name);
+    }
+    program.UniformBlockBinding(block_name, binding_);
+  }
+
+  /**
+   * Upload the value to a fresh region and bind it. The previous region is
+   * fenced here, after the commands of the previous frame.
+   */
+  void Update(const T &val) {
+    if (acquired_) stream_.Release();
+    const auto region = stream_.Acquire();
+    std::memcpy(region.data, &val, sizeof(T));
+    stream_.GetBuffer().BindRange(BufferTarget::UNIFORM_BUFFER, binding_,
+                                  region.offset, sizeof(T));
+    acquired_ = true;
+  }
+
+  [[nodiscard]] GLuint Binding() const { return binding_; }
+
+ private:
+  static GLsizeiptr OffsetAlignment() {
+    GLint alignment;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return alignment;
+  }
+
+  GLuint binding_;
+  StreamingBuffer stream_;
+  bool acquired_{false};
+};
+}  // namespace glpp
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "buffer.hpp"
+#include "gl.h"
+#include "streaming_buffer.hpp"
+
+namespace glpp {
+/**
+ * Collects buffer writes during a frame and flushes them at once, merging
+ * writes to overlapping or adjacent ranges of the same buffer into a single
+ * Buffer::CopySubData from a streaming staging buffer. Later writes win.
+ * Destination buffers must outlive the next Flush().
+ */
+class UploadQueue {
+ public:
+  explicit UploadQueue(GLsizeiptr capacity, GLsizei regions = 3)
+      : stream_(capacity, regions) {}
+
+  void Write(Buffer &dst, GLintptr offset, GLsizeiptr size, const void *data) {
+    const auto src = GLintptr(arena_.size());
+    const auto bytes = static_cast<const unsigned char *>(data);
+    arena_.insert(arena_.end(), bytes, bytes + size);
+    writes_.push_back({&dst, offset, size, src, 0});
+  }
+
+  // For STL containers
+  template <typename Container>
+  void Write(Buffer &dst, const Container &arr, GLintptr offset = 0) {
+    Write(dst, offset, arr.size() * sizeof(typename Container::value_type),
+          arr.data());
+  }
+
+  /**
+   * Issue the pending writes, returning the number of copies
+   */
+  std::size_t Flush() {
+    if (writes_.empty()) return 0;
+    const auto total = MergeRuns();
+
+    std::size_t copies = 0;
+    if (total <= stream_.RegionSize()) {
+      const auto region = stream_.Acquire();
+      Assemble(static_cast<unsigned char *>(region.data));
+      for (const auto &run : runs_) {
+        Buffer::CopySubData(stream_.GetBuffer(), *run.dst,
+                            region.offset + run.staging, run.offset,
+                            run.size);
+        ++copies;
+      }
+      stream_.Release();
+    } else {
+      // Too large for one region, split runs across several
+      scratch_.resize(total);
+      Assemble(scratch_.data());
+      StreamingBuffer::Region region{};
+      GLsizeiptr used = 0;
+      for (const auto &run : runs_) {
+        for (GLsizeiptr done = 0; done < run.size;) {
+          if (region.data == nullptr || used == region.size) {
+            if (region.data != nullptr) stream_.Release();
+            region = stream_.Acquire();
+            used = 0;
+          }
+          const auto size = std::min(run.size - done, region.size - used);
+          std::memcpy(static_cast<unsigned char *>(region.data) + used,
+                      scratch_.data() + run.staging + done, size);
+          Buffer::CopySubData(stream_.GetBuffer(), *run.dst,
+                              region.offset + used, run.offset + done,
+                              size);
+          ++copies;
+          used += size;
+          done += size;
+        }
+      }
+      if (region.data != nullptr) stream_.Release();
+    }
+
+    arena_.clear();
+    writes_.clear();
+    return copies;
+  }
+
+  [[nodiscard]] bool Empty() const { return writes_.empty(); }
+
+ private:
+  struct PendingWrite {
+    Buffer *dst;
+    GLintptr offset;
+    GLsizeiptr size;
+    GLintptr src;
+    std::size_t run;
+  };
+
+  struct Run {
+    Buffer *dst;
+    GLintptr offset;
+    GLsizeiptr size;
+    GLintptr staging;
+  };
+
+  /**
+   * Sort the writes by destination and merge them into runs, returning the
+   * total staging size
+   */
+  GLsizeiptr MergeRuns() {
+    order_.resize(writes_.size());
+    std::iota(order_.begin(), order_.end(), std::size_t{0});
+    std::sort(order_.begin(), order_.end(), [&](auto a, auto b) {
+      const auto &wa = writes_[a], &wb = writes_[b];
+      if (wa.dst->Id() != wb.dst->Id()) return wa.dst->Id() < wb.dst->Id();
+      return wa.offset < wb.offset;
+    });
+
+    runs_.clear();
+    for (const auto i : order_) {
+      auto &write = writes_[i];
+      if (!runs_.empty()) {
+        auto &run = runs_.back();
+        if (run.dst == write.dst && write.offset <= run.offset + run.size) {
+          run.size =
+              std::max(run.offset + run.size, write.offset + write.size) -
+              run.offset;
+          write.run = runs_.size() - 1;
+          continue;
+        }
+      }
+      runs_.push_back({write.dst, write.offset, write.size, 0});
+      write.run = runs_.size() - 1;
+    }
+
+    GLsizeiptr total = 0;
+    for (auto &run : runs_) {
+      run.staging = total;
+      total += run.size;
+    }
+    return total;
+  }
+
+  /**
+   * Replay the writes in submission order into the staging layout
+   */
+  void Assemble(unsigned char *staging) const {
+    for (const auto &write : writes_) {
+      const auto &run = runs_[write.run];
+      std::memcpy(staging + run.staging + (write.offset - run.offset),
+                  arena_.data() + write.src, write.size);
+    }
+  }
+
+  StreamingBuffer stream_;
+  std::vector<unsigned char> arena_, scratch_;
+  std::vector<PendingWrite> writes_;
+  std::vector<std::size_t> order_;
+  std::vector<Run> runs_;
+};
+}  // namespace glpp
@@ -6,17 +6,24 @@
 #include "buffer.hpp"
 #include "details/object.hpp"
 #include "gl.h"
+#include "name_pool.hpp"
 
 namespace glpp {
 namespace details {
 struct VertexArrayTrait {
   static GLuint Create() {
-    GLuint id;
-    glCreateVertexArrays(1, &id);
-    return id;
+    return NamePool<VertexArrayTrait>::Get().Acquire();
   }
 
-  static void Delete(GLuint id) { glDeleteVertexArrays(1, &id); }
+  static void Create(GLsizei n, GLuint *ids) { glCreateVertexArrays(n, ids); }
+
+  static void Delete(GLuint id) {
+    NamePool<VertexArrayTrait>::Get().Release(id);
+  }
+
+  static void Delete(GLsizei n, const GLuint *ids) {
+    glDeleteVertexArrays(n, ids);
+  }
 
   static void Bind(GLuint id) { glBindVertexArray(id); }
 };
@@ -24,6 +31,8 @@ struct VertexArrayTrait {
 
 class VertexArray : public details::Object<details::VertexArrayTrait> {
  public:
+  using details::Object<details::VertexArrayTrait>::Object;
+
   void BindElementBuffer(const Buffer &buffer) {
     glVertexArrayElementBuffer(Id(), buffer.Id());
   }
@@ -0,0 +1,151 @@
+#include <glpp/buffer_allocator.hpp>
+#include <stdexcept>
+#include <vector>
+
+#include "common.hpp"
+
+using namespace glpp;
+using namespace std;
+
+namespace {
+using Handle = BufferAllocator::Handle;
+
+unsigned char *Bytes(const BufferRange &range) {
+  return fake_gl::Data(range.buffer->Id()).data() + range.offset;
+}
+
+void TestAlignment() {
+  BufferAllocator allocator{1024, 0, 16};
+  const auto a = allocator.Allocate(100);
+  const auto b = allocator.Allocate(0);
+  const auto c = allocator.Allocate<float>(3);
+  CHECK(allocator.Get(a).offset == 0 && allocator.Get(a).size == 112);
+  CHECK(allocator.Get(b).offset == 112 && allocator.Get(b).size == 16);
+  CHECK(allocator.Get(c).offset == 128 && allocator.Get(c).size == 16);
+  CHECK(allocator.PageCount() == 1);
+}
+
+void TestCoalescing() {
+  BufferAllocator allocator{1024, 0, 16};
+  const auto a = allocator.Allocate(128);
+  const auto b = allocator.Allocate(128);
+  const auto c = allocator.Allocate(128);
+  const auto d = allocator.Allocate(640);
+
+  // Freeing the middle block last merges it with both neighbours
+  allocator.Free(a);
+  allocator.Free(c);
+  allocator.Free(b);
+  const auto merged = allocator.Allocate(384);
+  CHECK(allocator.Get(merged).offset == 0);
+  CHECK(allocator.PageCount() == 1);
+
+  // Freeing the block before the free tail merges them
+  allocator.Free(d);
+  allocator.Free(merged);
+  const auto whole = allocator.Allocate(1024);
+  CHECK(allocator.Get(whole).offset == 0);
+  CHECK(allocator.PageCount() == 1);
+}
+
+void TestBestFit() {
+  BufferAllocator allocator{1024, 0, 16};
+  vector<Handle> handles;
+  for (const GLsizeiptr size : {64, 16, 32, 16, 896}) {
+    handles.push_back(allocator.Allocate(size));
+  }
+  allocator.Free(handles[0]);
+  allocator.Free(handles[2]);
+
+  // The 32 byte hole fits exactly, the 64 byte one comes first
+  const auto fit = allocator.Allocate(32);
+  CHECK(allocator.Get(fit).offset == 80);
+  const auto next = allocator.Allocate(48);
+  CHECK(allocator.Get(next).offset == 0);
+  CHECK(allocator.PageCount() == 1);
+}
+
+void TestNewPage() {
+  BufferAllocator allocator{256, 0, 16};
+  const auto a = allocator.Allocate(256);
+  const auto b = allocator.Allocate(16);
+  CHECK(allocator.PageCount() == 2);
+  CHECK(allocator.Get(a).buffer != allocator.Get(b).buffer);
+
+  // Larger than a page, gets a page of its own size
+  const auto large = allocator.Allocate(1000);
+  CHECK(allocator.PageCount() == 3);
+  CHECK(fake_gl::Data(allocator.Get(large).buffer->Id()).size() == 1008);
+}
+
+void TestHandles() {
+  BufferAllocator allocator{1024, 0, 16};
+  const auto a = allocator.Allocate(16);
+  allocator.Free(a);
+  CHECK_THROWS(allocator.Get(a), out_of_range);
+  CHECK_THROWS(allocator.Free(a), out_of_range);
+  CHECK_THROWS(allocator.Get(42), out_of_range);
+  CHECK(allocator.Allocate(16) == a);
+}
+
+void TestReallocate() {
+  BufferAllocator allocator{1024, 0, 16};
+  const auto a = allocator.Allocate(64);
+  const auto b = allocator.Allocate(64);
+  const auto c = allocator.Allocate(64);
+  allocator.Free(b);
+
+  // Shrinking and growing into the following free block stay in place
+  allocator.Reallocate(a, 32);
+  CHECK(allocator.Get(a).offset == 0 && allocator.Get(a).size == 32);
+  allocator.Reallocate(a, 128);
+  CHECK(allocator.Get(a).offset == 0 && allocator.Get(a).size == 128);
+  CHECK(fake_gl::state.copies.empty());
+
+  // Otherwise the range moves with its content
+  Bytes(allocator.Get(a))[0] = 7;
+  Bytes(allocator.Get(a))[127] = 9;
+  allocator.Reallocate(a, 256);
+  const auto moved = allocator.Get(a);
+  CHECK(moved.offset == 192 && moved.size == 256);
+  CHECK(fake_gl::state.copies.size() == 1);
+  CHECK(Bytes(moved)[0] == 7 && Bytes(moved)[127] == 9);
+  CHECK(allocator.Get(c).offset == 128);
+
+  // The old range is free again
+  const auto reused = allocator.Allocate(128);
+  CHECK(allocator.Get(reused).offset == 0);
+  fake_gl::state.copies.clear();
+}
+
+void TestDefragment() {
+  BufferAllocator allocator{256, 0, 16};
+  vector<Handle> handles;
+  for (int i = 0; i < 32; ++i) handles.push_back(allocator.Allocate(16));
+  CHECK(allocator.PageCount() == 2);
+  for (int i = 0; i < 32; ++i) Bytes(allocator.Get(handles[i]))[0] = i;
+  for (int i = 0; i < 32; i += 2) allocator.Free(handles[i]);
+
+  // Limited to two allocations per call
+  CHECK(allocator.Defragment(32) == 32);
+  CHECK(allocator.PageCount() == 2);
+  CHECK(allocator.Defragment(1 << 20) == 96);
+  CHECK(allocator.PageCount() == 1);
+  for (int i = 1; i < 32; i += 2) {
+    CHECK(Bytes(allocator.Get(handles[i]))[0] == i);
+  }
+  CHECK(allocator.Defragment(1 << 20) == 0);
+  fake_gl::state.copies.clear();
+}
+}  // namespace
+
+int main() {
+  fake_gl::Install();
+  TestAlignment();
+  TestCoalescing();
+  TestBestFit();
+  TestNewPage();
+  TestHandles();
+  TestReallocate();
+  TestDefragment();
+}
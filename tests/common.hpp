@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <glpp/gl.h>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#define CHECK(condition)                                             \
+  do {                                                               \
+    if (!(condition)) {                                              \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " \
+                << #condition << std::endl;                          \
+      std::exit(EXIT_FAILURE);                                       \
+    }                                                                \
+  } while (false)
+
+#define CHECK_THROWS(expression, exception)                           \
+  do {                                                                \
+    bool thrown = false;                                              \
+    try {                                                             \
+      static_cast<void>(expression);                                  \
+    } catch (const exception &) {                                     \
+      thrown = true;                                                  \
+    }                                                                 \
+    if (!thrown) {                                                    \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": " << #expression \
+                << " did not throw " << #exception << std::endl;      \
+      std::exit(EXIT_FAILURE);                                        \
+    }                                                                 \
+  } while (false)
+
+/**
+ * Stand-in for the buffer and sync entry points keeping buffers in host
+ * memory, so that the CPU-side logic runs without a context. Fences are
+ * always signaled.
+ */
+namespace fake_gl {
+struct Copy {
+  GLuint src, dst;
+  GLintptr src_offset, dst_offset;
+  GLsizeiptr size;
+};
+
+struct State {
+  GLuint next_name{1};
+  std::map<GLuint, std::vector<unsigned char>> buffers;
+  std::vector<Copy> copies;
+};
+
+inline State state;
+
+inline std::vector<unsigned char> &Data(GLuint buffer) {
+  return state.buffers.at(buffer);
+}
+
+inline void Install() {
+  glad_glCreateBuffers = [](GLsizei n, GLuint *buffers) {
+    for (GLsizei i = 0; i < n; ++i) buffers[i] = state.next_name++;
+  };
+  glad_glDeleteBuffers = [](GLsizei n, const GLuint *buffers) {
+    for (GLsizei i = 0; i < n; ++i) state.buffers.erase(buffers[i]);
+  };
+  glad_glNamedBufferStorage = [](GLuint buffer, GLsizeiptr size,
+                                 const void *data, GLbitfield) {
+    auto &storage = state.buffers[buffer];
+    storage.assign(std::size_t(size), 0);
+    if (data != nullptr) std::memcpy(storage.data(), data, storage.size());
+  };
+  glad_glNamedBufferSubData = [](GLuint buffer, GLintptr offset,
+                                 GLsizeiptr size, const void *data) {
+    std::memcpy(Data(buffer).data() + offset, data, std::size_t(size));
+  };
+  glad_glMapNamedBufferRange = [](GLuint buffer, GLintptr offset, GLsizeiptr,
+                                  GLbitfield) -> void * {
+    return Data(buffer).data() + offset;
+  };
+  glad_glUnmapNamedBuffer = [](GLuint) -> GLboolean { return GL_TRUE; };
+  glad_glCopyNamedBufferSubData = [](GLuint src, GLuint dst,
+                                     GLintptr src_offset, GLintptr dst_offset,
+                                     GLsizeiptr size) {
+    std::memmove(Data(dst).data() + dst_offset, Data(src).data() + src_offset,
+                 std::size_t(size));
+    state.copies.push_back({src, dst, src_offset, dst_offset, size});
+  };
+  glad_glFenceSync = [](GLenum, GLbitfield) {
+    static char fence;
+    return reinterpret_cast<GLsync>(&fence);
+  };
+  glad_glDeleteSync = [](GLsync) {};
+  glad_glClientWaitSync = [](GLsync, GLbitfield, GLuint64) -> GLenum {
+    return GL_ALREADY_SIGNALED;
+  };
+  glad_glGetSynciv = [](GLsync, GLenum, GLsizei, GLsizei *, GLint *values) {
+    *values = GL_SIGNALED;
+  };
+}
+}  // namespace fake_gl
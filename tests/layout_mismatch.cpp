@@ -0,0 +1,22 @@
+// Must not compile, see CMakeLists.txt
+#include <glm/glm.hpp>
+#include <glpp/typed_buffer.hpp>
+
+namespace {
+#ifdef MEMBER_MISMATCH
+struct Segment {
+  glm::vec3 begin;
+  glm::vec3 end;
+};
+#endif
+}  // namespace
+
+#ifdef MEMBER_MISMATCH
+GLPP_LAYOUT(Std430, Segment, begin, end);
+#endif
+
+int main() {
+#ifdef ARRAY_MISMATCH
+  glpp::TypedBuffer<glm::vec3> buffer;
+#endif
+}
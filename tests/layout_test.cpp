@@ -0,0 +1,108 @@
+#include <glm/glm.hpp>
+#include <glpp/typed_buffer.hpp>
+#include <vector>
+
+#include "common.hpp"
+
+using namespace glm;
+using namespace glpp;
+using namespace std;
+
+namespace {
+struct Particle {
+  vec4 position;
+  vec3 velocity;
+  float mass;
+  mat4 transform;
+};
+
+struct Pair {
+  vec2 a;
+  vec2 b;
+};
+
+struct Nested {
+  Particle particles[2];
+  Pair pair;
+  float weights[4];
+};
+
+struct Light {
+  vec3 color;
+  float intensity;
+  vec4 directions[2];
+};
+}  // namespace
+
+GLPP_LAYOUT(Std430, Particle, position, velocity, mass, transform);
+GLPP_LAYOUT(Std140, Particle, position, velocity, mass, transform);
+GLPP_LAYOUT(Std430, Pair, a, b);
+GLPP_LAYOUT(Std140, Pair, a, b);
+GLPP_LAYOUT(Std430, Nested, particles, pair, weights);
+GLPP_LAYOUT(Std140, Light, color, intensity, directions);
+
+namespace {
+template <typename Layout, typename T>
+constexpr std::size_t kAlignment = details::LayoutTraits<Layout, T>::alignment;
+
+template <typename Layout, typename T>
+constexpr std::size_t kSize = details::LayoutTraits<Layout, T>::size;
+
+template <typename Layout, typename T>
+constexpr bool kCompatible = details::IsLayoutCompatible<Layout, T>();
+
+// Scalars and vectors are the same in both layouts
+static_assert(kAlignment<Std140, float> == 4 && kSize<Std140, float> == 4);
+static_assert(kAlignment<Std430, vec2> == 8 && kSize<Std430, vec2> == 8);
+static_assert(kAlignment<Std140, vec3> == 16 && kSize<Std140, vec3> == 12);
+static_assert(kAlignment<Std430, dvec2> == 16 && kSize<Std430, dvec2> == 16);
+static_assert(kAlignment<Std430, dvec3> == 32 && kSize<Std430, dvec3> == 24);
+
+// std140 rounds array and matrix column alignment up to vec4
+static_assert(kAlignment<Std430, vec2[3]> == 8 && kSize<Std430, vec2[3]> == 24);
+static_assert(kAlignment<Std140, vec4[3]> == 16 &&
+              kSize<Std140, vec4[3]> == 48);
+static_assert(kAlignment<Std430, mat2> == 8 && kSize<Std430, mat2> == 16);
+static_assert(kAlignment<Std140, mat2> == 16 && kSize<Std140, mat2> == 32);
+static_assert(kSize<Std430, mat3> == 48 && kSize<Std430, mat4> == 64);
+
+// Arrays of T in C++ have the layout stride
+static_assert(kCompatible<Std430, float> && kCompatible<Std430, vec2>);
+static_assert(!kCompatible<Std430, vec3> && !kCompatible<Std140, vec3>);
+static_assert(kCompatible<Std430, vec4> && kCompatible<Std140, vec4>);
+static_assert(kCompatible<Std430, mat2> && !kCompatible<Std140, mat2>);
+static_assert(!kCompatible<Std430, mat3> && kCompatible<Std140, mat4>);
+
+// Registered structs
+static_assert(kAlignment<Std430, Particle> == 16 &&
+              kSize<Std430, Particle> == 96);
+static_assert(kSize<Std140, Particle> == 96);
+static_assert(kAlignment<Std430, Pair> == 8 && kSize<Std430, Pair> == 16);
+static_assert(kAlignment<Std140, Pair> == 16 && kSize<Std140, Pair> == 16);
+static_assert(kSize<Std430, Nested> == 224);
+static_assert(kSize<Std140, Light> == 48);
+static_assert(kCompatible<Std430, Particle> && kCompatible<Std430, Nested>);
+
+void TestTypedBufferIndexing() {
+  TypedBuffer<Particle> buffer;
+  buffer.CreateStorage(4);
+  CHECK(buffer.Size() == 4);
+  CHECK(fake_gl::Data(buffer.Id()).size() == 4 * sizeof(Particle));
+
+  vector<Particle> particles(2);
+  particles[1].mass = 2;
+  buffer.SetSubData(particles, 2);
+  Particle stored;
+  memcpy(&stored, fake_gl::Data(buffer.Id()).data() + 3 * sizeof(Particle),
+         sizeof(Particle));
+  CHECK(stored.mass == 2);
+
+  const auto mapped = buffer.MapRange(2, 2, GL_MAP_READ_BIT);
+  CHECK(mapped[1].mass == 2);
+}
+}  // namespace
+
+int main() {
+  fake_gl::Install();
+  TestTypedBufferIndexing();
+}
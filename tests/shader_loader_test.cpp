@@ -0,0 +1,123 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <glpp/shader_loader.hpp>
+#include <stdexcept>
+#include <string>
+
+#include "common.hpp"
+
+using namespace glpp;
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+const auto kRoot = fs::temp_directory_path() / "glpp_shader_loader_test";
+
+void WriteFile(const fs::path &path, const string &content) {
+  fs::create_directories(path.parent_path());
+  ofstream(path, ios::binary) << content;
+}
+
+void TestExpansion() {
+  WriteFile(kRoot / "a.vert",
+            "#version 450\n"
+            "#include \"lib/common.glsl\"\n"
+            "  #include <util.glsl>\n"
+            "void main() {}\n");
+  WriteFile(kRoot / "lib/common.glsl",
+            "#include \"../inc/util.glsl\"\n"
+            "float common;");
+  WriteFile(kRoot / "inc/util.glsl", "float util;\n");
+
+  // util.glsl is found in the include directory the second time, and only
+  // included once
+  ShaderLoader loader{{kRoot / "inc"}};
+  CHECK(loader.Load(kRoot / "a.vert") ==
+        "#version 450\n"
+        "#line 1 1\n"
+        "#line 1 2\n"
+        "float util;\n"
+        "#line 2 1\n"
+        "float common;\n"
+        "#line 3 0\n"
+        "#line 4 0\n"
+        "void main() {}\n");
+
+  const auto dependencies = loader.Dependencies(kRoot / "a.vert");
+  CHECK(dependencies.size() == 3);
+  CHECK(dependencies[0] == fs::canonical(kRoot / "a.vert"));
+  CHECK(dependencies[1] == fs::canonical(kRoot / "lib/common.glsl"));
+  CHECK(dependencies[2] == fs::canonical(kRoot / "inc/util.glsl"));
+}
+
+void TestSkippedDirectives() {
+  const string source =
+      "/* #include \"missing.glsl\"\n"
+      "   #include \"missing.glsl\" */\n"
+      "#if 0\n"
+      "#ifdef FOO\n"
+      "#endif\n"
+      "#include \"missing.glsl\"\n"
+      "#else\n"
+      "#include \"inc/util.glsl\"\n"
+      "#endif\n"
+      "#if 01\n"
+      "#endif\n";
+  WriteFile(kRoot / "skip.frag", source);
+
+  ShaderLoader loader;
+  const auto expanded = loader.Load(kRoot / "skip.frag");
+  CHECK(expanded.find("float util;\n#line 9 0\n#endif\n") != string::npos);
+  CHECK(expanded.find("#include \"missing.glsl\"\n#else") != string::npos);
+  CHECK(loader.Dependencies(kRoot / "skip.frag").size() == 2);
+}
+
+void TestErrors() {
+  ShaderLoader loader;
+  WriteFile(kRoot / "cycle_a.glsl", "#include \"cycle_b.glsl\"\n");
+  WriteFile(kRoot / "cycle_b.glsl", "#include \"cycle_a.glsl\"\n");
+  CHECK_THROWS(loader.Load(kRoot / "cycle_a.glsl"), runtime_error);
+
+  WriteFile(kRoot / "missing.glsl", "#include \"none.glsl\"\n");
+  CHECK_THROWS(loader.Load(kRoot / "missing.glsl"), runtime_error);
+  CHECK_THROWS(loader.Load(kRoot / "none.glsl"), runtime_error);
+
+  WriteFile(kRoot / "malformed.glsl", "#include \"util.glsl\n");
+  CHECK_THROWS(loader.Load(kRoot / "malformed.glsl"), runtime_error);
+}
+
+void TestChanges() {
+  ShaderLoader loader{{kRoot / "inc"}};
+  loader.Load(kRoot / "a.vert");
+  WriteFile(kRoot / "b.frag", "#include \"lib/common.glsl\"\n");
+  loader.Load(kRoot / "b.frag");
+  CHECK(loader.Dependents(kRoot / "inc/util.glsl").size() == 2);
+  CHECK(loader.Dependents(kRoot / "a.vert").size() == 1);
+
+  // Files are read again when their modification time changes
+  const auto hash = loader.Hash(kRoot / "a.vert");
+  const auto util = kRoot / "inc/util.glsl";
+  const auto mtime = fs::last_write_time(util);
+  WriteFile(util, "float other;\n");
+  fs::last_write_time(util, mtime + chrono::seconds(1));
+  CHECK(loader.Hash(kRoot / "a.vert") != hash);
+  CHECK(loader.Load(kRoot / "a.vert").find("float other;") != string::npos);
+
+  // Or when invalidated
+  WriteFile(util, "float again;\n");
+  fs::last_write_time(util, mtime + chrono::seconds(1));
+  CHECK(loader.Load(kRoot / "a.vert").find("float other;") != string::npos);
+  loader.Invalidate(util);
+  CHECK(loader.Load(kRoot / "a.vert").find("float again;") != string::npos);
+}
+}  // namespace
+
+int main() {
+  fs::remove_all(kRoot);
+  TestExpansion();
+  TestSkippedDirectives();
+  TestErrors();
+  TestChanges();
+  fs::remove_all(kRoot);
+}
@@ -0,0 +1,97 @@
+#include <glpp/upload_queue.hpp>
+#include <vector>
+
+#include "common.hpp"
+
+using namespace glpp;
+using namespace std;
+
+namespace {
+vector<unsigned char> Filled(size_t size, unsigned char value) {
+  return vector<unsigned char>(size, value);
+}
+
+void TestMerging() {
+  UploadQueue queue{256};
+  Buffer a, b;
+  a.CreateStorage(GLsizeiptr(64));
+  b.CreateStorage(GLsizeiptr(64));
+  fake_gl::state.copies.clear();
+
+  queue.Write(b, Filled(4, 1));
+  queue.Write(a, Filled(8, 1), 8);
+  queue.Write(a, Filled(4, 2), 4);   // Adjacent
+  queue.Write(a, Filled(2, 3), 10);  // Overlapping
+  queue.Write(a, Filled(2, 4), 20);  // Separate
+  CHECK(!queue.Empty());
+  CHECK(queue.Flush() == 3);
+  CHECK(queue.Empty());
+
+  const auto &copies = fake_gl::state.copies;
+  CHECK(copies.size() == 3);
+  for (const auto &copy : copies) {
+    if (copy.dst == b.Id()) {
+      CHECK(copy.dst_offset == 0 && copy.size == 4);
+    } else if (copy.dst_offset == 4) {
+      CHECK(copy.size == 12);
+    } else {
+      CHECK(copy.dst_offset == 20 && copy.size == 2);
+    }
+  }
+
+  const vector<unsigned char> expected{0, 0, 0, 0, 2, 2, 2, 2, 1, 1, 3,
+                                       3, 1, 1, 1, 1, 0, 0, 0, 0, 4, 4};
+  CHECK(equal(expected.begin(), expected.end(), fake_gl::Data(a.Id()).begin()));
+  CHECK(fake_gl::Data(b.Id())[3] == 1 && fake_gl::Data(b.Id())[4] == 0);
+  fake_gl::state.copies.clear();
+}
+
+void TestLaterWriteWins() {
+  UploadQueue queue{256};
+  Buffer buffer;
+  buffer.CreateStorage(GLsizeiptr(16));
+
+  // The second write starts first in the run but is applied last
+  queue.Write(buffer, Filled(8, 1), 8);
+  queue.Write(buffer, Filled(8, 2), 4);
+  CHECK(queue.Flush() == 1);
+  const auto &data = fake_gl::Data(buffer.Id());
+  CHECK(data[4] == 2 && data[11] == 2 && data[12] == 1 && data[15] == 1);
+  fake_gl::state.copies.clear();
+}
+
+void TestSplitAcrossRegions() {
+  UploadQueue queue{256};
+  Buffer buffer;
+  buffer.CreateStorage(GLsizeiptr(1024));
+  fake_gl::state.copies.clear();
+
+  vector<unsigned char> bytes(700);
+  for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = i % 251;
+  queue.Write(buffer, bytes, 100);
+  queue.Write(buffer, Filled(10, 7), 50);
+
+  // 710 bytes in regions of 256, the large run split in three
+  CHECK(queue.Flush() == 4);
+  for (const auto &copy : fake_gl::state.copies) CHECK(copy.size <= 256);
+  const auto &data = fake_gl::Data(buffer.Id());
+  for (size_t i = 0; i < bytes.size(); ++i) CHECK(data[100 + i] == i % 251);
+  CHECK(data[50] == 7 && data[59] == 7 && data[60] == 0);
+  fake_gl::state.copies.clear();
+}
+
+void TestEmptyFlush() {
+  UploadQueue queue{256};
+  CHECK(queue.Empty());
+  CHECK(queue.Flush() == 0);
+  CHECK(fake_gl::state.copies.empty());
+}
+}  // namespace
+
+int main() {
+  fake_gl::Install();
+  TestMerging();
+  TestLaterWriteWins();
+  TestSplitAcrossRegions();
+  TestEmptyFlush();
+}